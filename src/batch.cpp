@@ -0,0 +1,462 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*!
+	\file batch.cpp
+    \brief the batch evaluator - expressions are read line by line from files or stdin
+*/
+
+#include "compileconfig.h"
+#include "evaluator.h"
+#include "batchpool.h"
+#include "tabulation.h"
+#include "sweep.h"
+#include "commandline.h"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+namespace Batch
+{
+EvaluatorSettings settings;
+ttmath::Objects variables;
+ttmath::Objects functions;
+Languages languages;
+
+// used when there is only one thread
+LineEvaluator line_evaluator;
+
+// used when there are more threads
+BatchPool pool;
+
+bool echo       = false;
+bool statistics = true;
+const char * config_file = 0;
+
+// zero means as many threads as processors
+unsigned int threads = 1;
+
+// the tabulation mode (-T), each line is calculated for many values of the variables
+// (one variable is tabulated in order, more variables are swept)
+Tabulation tabulation;
+Sweep sweep;
+std::vector<TabulationAxis> tab_axes;
+bool tsv = false;
+unsigned long tab_points  = 0;
+unsigned long tab_errors  = 0;
+
+std::string line, result;
+
+
+
+void PrintUsage()
+{
+	fprintf(stderr,
+		"usage: ttcalcbatch [options] [file...]\n"
+		"expressions are read line by line from the files (or from stdin if there are\n"
+		"no files or a file is '-') and the results are written in the same order\n"
+		"to stdout, one line of results for one line of input\n\n"
+		"  -c file        read variables and functions from a ttcalc.ini file\n"
+		"  -e             print the expression before its result (expression = result)\n"
+		"  -q             don't print statistics on stderr\n"
+		"  -t threads     evaluate by more threads (0 - as many as processors),\n"
+		"                 the input is then read in blocks of lines (default: 1)\n"
+		"  -T variable start step count\n"
+		"                 tabulate each expression for variable = start + i*step,\n"
+		"                 i = 0..count-1 (start and step can be expressions too),\n"
+		"                 the points are written in the CSV format and are divided\n"
+		"                 between the threads given by -t, -T can be given up to 4 times\n"
+		"                 for a sweep over the grid of all variables (rows of a sweep\n"
+		"                 are written in the order in which they are finished)\n"
+		"  -tsv           write the points separated by tabulators\n");
+
+	CommandLine::PrintSettingsOptions(stderr);
+}
+
+
+/*!
+	the evaluator (or evaluators for each thread) is prepared only once
+	- the same parser is used for every line
+*/
+void Init()
+{
+	languages.InitAll();
+	languages.SetCurrentLanguage(Languages::en);
+
+	if( threads == 0 )
+		threads = HowManyProcessors();
+
+	if( !tab_axes.empty() )
+	{
+		tabulation.SetThreads(threads);
+		sweep.SetThreads(threads);
+		sweep.SetFormat(tsv ? Sweep::tsv : Sweep::csv);
+		return;
+	}
+
+	if( threads > 1 )
+	{
+		if( pool.Start(threads, settings, variables, functions, &languages, echo) )
+			return;
+
+		fprintf(stderr, "ttcalcbatch: I cannot create threads, only one thread is used\n");
+		threads = 1;
+	}
+
+	line_evaluator.Init(settings, variables, functions, &languages, echo);
+}
+
+
+void WriteResult(BatchPool::Block * block, std::ostream & out)
+{
+	out.write(block->output.c_str(), block->output.size());
+	pool.Release(block);
+}
+
+
+/*!
+	lines are read in blocks and evaluated by the pool,
+	only a limited number of blocks is kept in memory
+*/
+void EvaluateStreamParallel(std::istream & in, std::ostream & out)
+{
+BatchPool::Block * block;
+bool end = false;
+
+	while( !end )
+	{
+		block = pool.GetBlock();
+
+		if( !block )
+		{
+			// too many blocks are in use
+			WriteResult(pool.GetResult(), out);
+			continue;
+		}
+
+		while( block->size < block->lines.size() && std::getline(in, block->lines[block->size]) )
+			block->size += 1;
+
+		end = block->size < block->lines.size();
+
+		if( block->size > 0 )
+			pool.Put(block);
+		else
+			pool.Release(block);
+	}
+
+	while( (block = pool.GetResult()) != 0 )
+		WriteResult(block, out);
+}
+
+
+ttmath::ErrorCode Tabulate(std::ostream & out)
+{
+	if( tab_axes.size() > 1 )
+	{
+		ttmath::ErrorCode code = sweep.Run(line.c_str(), tab_axes, settings, variables, functions, &languages, out);
+
+		tab_points += sweep.Points();
+		tab_errors += sweep.Errors();
+
+		return code;
+	}
+
+	const TabulationAxis & axis = tab_axes[0];
+	TabulationCsvOutput csv(out, settings);
+
+	if( tsv )
+		csv.SetSeparator('\t');
+
+	csv.PutHeader(axis.variable, line);
+
+	ttmath::ErrorCode code = tabulation.Run(line.c_str(), axis.variable.c_str(), axis.start.c_str(),
+											axis.step.c_str(), axis.count, settings, variables,
+											functions, &languages, csv);
+
+	tab_points += tabulation.Points();
+	tab_errors += tabulation.Errors();
+
+return code;
+}
+
+
+/*!
+	each line is an expression calculated for the points given by -T,
+	every expression gives a header and one CSV line for each point
+*/
+void TabulateStream(std::istream & in, std::ostream & out)
+{
+	while( std::getline(in, line) )
+	{
+		if( !line.empty() && line[line.size()-1] == '\r' )
+			line.erase(line.size()-1);
+
+		if( line.find_first_not_of(" \t") == std::string::npos )
+			continue;
+
+		ttmath::ErrorCode code = Tabulate(out);
+
+		if( code != ttmath::err_ok )
+		{
+			++tab_errors;
+			fprintf(stderr, "ttcalcbatch: %s: %s\n", line.c_str(), languages.ErrorMessage(settings.country, code));
+		}
+	}
+}
+
+
+/*!
+	only one line is kept in memory at a time
+*/
+void EvaluateStream(std::istream & in, std::ostream & out)
+{
+	if( !tab_axes.empty() )
+	{
+		TabulateStream(in, out);
+		return;
+	}
+
+	if( threads > 1 )
+	{
+		EvaluateStreamParallel(in, out);
+		return;
+	}
+
+	while( std::getline(in, line) )
+	{
+		result.clear();
+		line_evaluator.Evaluate(line, result);
+		out << result;
+	}
+}
+
+
+bool EvaluateFile(const char * file_name, std::ostream & out)
+{
+	if( strcmp(file_name, "-") == 0 )
+	{
+		EvaluateStream(std::cin, out);
+		return true;
+	}
+
+	std::ifstream file(file_name, std::ios_base::in | std::ios_base::binary);
+
+	if( !file )
+	{
+		fprintf(stderr, "ttcalcbatch: I cannot open: %s\n", file_name);
+		return false;
+	}
+
+	EvaluateStream(file, out);
+
+return true;
+}
+
+
+/*!
+	returning false if the program should finish
+*/
+bool ReadArguments(int argc, char ** argv, std::vector<const char*> & files)
+{
+bool error;
+
+	for(int i=1 ; i<argc ; ++i)
+	{
+		if( CommandLine::ReadSettingsOption(argc, argv, i, settings, error) )
+		{
+			if( error )
+			{
+				fprintf(stderr, "ttcalcbatch: a value for %s is missing\n", argv[i]);
+				return false;
+			}
+		}
+		else
+		if( strcmp(argv[i], "-c") == 0 && i+1<argc )
+		{
+			config_file = argv[++i];
+		}
+		else
+		if( strcmp(argv[i], "-e") == 0 )
+		{
+			echo = true;
+		}
+		else
+		if( strcmp(argv[i], "-q") == 0 )
+		{
+			statistics = false;
+		}
+		else
+		if( strcmp(argv[i], "-t") == 0 && i+1<argc )
+		{
+			threads = (unsigned int)atoi(argv[++i]);
+		}
+		else
+		if( strcmp(argv[i], "-T") == 0 && i+4<argc && tab_axes.size() < Sweep::max_axes )
+		{
+			TabulationAxis axis;
+			axis.variable = argv[++i];
+			axis.start    = argv[++i];
+			axis.step     = argv[++i];
+			axis.count    = strtoul(argv[++i], 0, 10);
+			tab_axes.push_back(axis);
+		}
+		else
+		if( strcmp(argv[i], "-tsv") == 0 )
+		{
+			tsv = true;
+		}
+		else
+		if( argv[i][0] == '-' && argv[i][1] != 0 )
+		{
+			PrintUsage();
+			return false;
+		}
+		else
+		{
+			files.push_back(argv[i]);
+		}
+	}
+
+return true;
+}
+
+
+bool ReadConfig()
+{
+	if( !config_file )
+		return true;
+
+	int bad_line = -1;
+	IniParser::Error err = CommandLine::ReadVariablesFunctions(config_file, variables, functions, &bad_line);
+
+	if( err == IniParser::err_cant_open_file )
+	{
+		fprintf(stderr, "ttcalcbatch: I cannot open: %s\n", config_file);
+		return false;
+	}
+
+	if( err != IniParser::err_ok )
+		fprintf(stderr, "ttcalcbatch: %s: syntax error in line %d\n", config_file, bad_line);
+
+return true;
+}
+
+
+void PrintStatistics(double time)
+{
+unsigned long expressions, errors;
+
+	if( !statistics )
+		return;
+
+	if( !tab_axes.empty() )
+	{
+		fprintf(stderr, "ttcalcbatch: %lu points (%lu errors) in %.3f s", tab_points, tab_errors, time);
+
+		if( time > 0.0 )
+			fprintf(stderr, ", %.0f points/s", double(tab_points) / time);
+
+		fprintf(stderr, "\n");
+		return;
+	}
+
+	if( threads > 1 )
+	{
+		expressions = pool.Expressions();
+		errors      = pool.Errors();
+	}
+	else
+	{
+		expressions = line_evaluator.expressions;
+		errors      = line_evaluator.errors;
+	}
+
+	fprintf(stderr, "ttcalcbatch: %lu expressions (%lu errors) in %.3f s",
+					expressions, errors, time);
+
+	if( time > 0.0 )
+		fprintf(stderr, ", %.0f expressions/s", double(expressions) / time);
+
+	fprintf(stderr, "\n");
+}
+
+
+} // namespace Batch
+
+
+
+int main(int argc, char ** argv)
+{
+using namespace Batch;
+
+std::vector<const char*> files;
+bool all_opened = true;
+
+	if( !ReadArguments(argc, argv, files) )
+		return 2;
+
+	if( !ReadConfig() )
+		return 2;
+
+	std::ios_base::sync_with_stdio(false);
+	Init();
+
+	if( files.empty() )
+		files.push_back("-");
+
+	double start = CommandLine::GetTime();
+
+	for(size_t i=0 ; i<files.size() ; ++i)
+		if( !EvaluateFile(files[i], std::cout) )
+			all_opened = false;
+
+	std::cout.flush();
+
+	// the statistics from the workers are collected when they finish
+	pool.Stop();
+	PrintStatistics(CommandLine::GetTime() - start);
+
+return all_opened ? 0 : 1;
+}
+
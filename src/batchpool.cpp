@@ -0,0 +1,341 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "compileconfig.h"
+#include "batchpool.h"
+
+
+
+LineEvaluator::LineEvaluator()
+{
+	expressions = 0;
+	errors      = 0;
+	languages   = 0;
+	echo        = false;
+}
+
+
+void LineEvaluator::Init(const EvaluatorSettings & psettings,
+						 const ttmath::Objects & pvariables,
+						 const ttmath::Objects & pfunctions,
+						 Languages * planguages,
+						 bool pecho)
+{
+	settings  = psettings;
+	variables = pvariables;
+	functions = pfunctions;
+	languages = planguages;
+	echo      = pecho;
+
+	evaluator.SetVariables(&variables);
+	evaluator.SetFunctions(&functions);
+	evaluator.SetLanguages(languages);
+}
+
+
+bool LineEvaluator::IsEmpty(const std::string & str)
+{
+	for(size_t i=0 ; i<str.size() ; ++i)
+		if( str[i]!=' ' && str[i]!='\t' )
+			return false;
+
+return true;
+}
+
+
+void LineEvaluator::Evaluate(std::string & line, std::string & out)
+{
+	// files from windows
+	if( !line.empty() && line[line.size()-1] == '\r' )
+		line.erase(line.size()-1);
+
+	if( IsEmpty(line) )
+	{
+		out += '\n';
+		return;
+	}
+
+	if( echo )
+	{
+		out += line;
+		out += " = ";
+	}
+
+	ttmath::ErrorCode code = evaluator.Parse(line.c_str(), settings);
+	++expressions;
+
+	if( code == ttmath::err_ok )
+	{
+		if( evaluator.Calculated() )
+		{
+			if( evaluator.PrintResult(result, "  ;  ") )
+				code = ttmath::err_overflow;
+			else
+				out += result;
+		}
+	}
+
+	if( code != ttmath::err_ok )
+	{
+		++errors;
+		out += "error: ";
+		out += languages->ErrorMessage(settings.country, code);
+	}
+
+	out += '\n';
+}
+
+
+
+
+BatchPool::Block::Block() : lines(block_lines)
+{
+	size = 0;
+	seq  = 0;
+}
+
+
+
+BatchPool::BatchPool()
+{
+	max_blocks  = 0;
+	next_seq    = 0;
+	next_result = 0;
+	in_progress = 0;
+	stop        = false;
+	expressions = 0;
+	errors      = 0;
+}
+
+
+BatchPool::~BatchPool()
+{
+	Stop();
+}
+
+
+bool BatchPool::Start(unsigned int workers_count,
+					  const EvaluatorSettings & settings,
+					  const ttmath::Objects & variables,
+					  const ttmath::Objects & functions,
+					  Languages * languages,
+					  bool echo)
+{
+	Stop();
+
+	if( workers_count == 0 )
+		workers_count = 1;
+
+	stop        = false;
+	next_seq    = 0;
+	next_result = 0;
+	in_progress = 0;
+	expressions = 0;
+	errors      = 0;
+	max_blocks  = workers_count * blocks_per_worker;
+
+	for(unsigned int i=0 ; i<workers_count ; ++i)
+	{
+		Worker * worker = new Worker();
+		worker->pool = this;
+		worker->evaluator.Init(settings, variables, functions, languages, echo);
+
+		if( !StartThread(worker->thread, WorkerThread, worker) )
+		{
+			delete worker;
+			Stop();
+			return false;
+		}
+
+		workers.push_back(worker);
+	}
+
+return true;
+}
+
+
+void BatchPool::Stop()
+{
+	mutex.Lock();
+	stop = true;
+	work_cond.Broadcast();
+	mutex.Unlock();
+
+	for(size_t i=0 ; i<workers.size() ; ++i)
+	{
+		JoinThread(workers[i]->thread);
+		expressions += workers[i]->evaluator.expressions;
+		errors      += workers[i]->evaluator.errors;
+		delete workers[i];
+	}
+
+	workers.clear();
+	DeleteBlocks();
+}
+
+
+void BatchPool::DeleteBlocks()
+{
+	for(size_t i=0 ; i<blocks.size() ; ++i)
+		delete blocks[i];
+
+	blocks.clear();
+	free_blocks.clear();
+	queue.clear();
+	finished.clear();
+	in_progress = 0;
+}
+
+
+BatchPool::Block * BatchPool::GetBlock()
+{
+Block * block;
+
+	if( !free_blocks.empty() )
+	{
+		block = free_blocks.back();
+		free_blocks.pop_back();
+	}
+	else
+	if( blocks.size() < max_blocks )
+	{
+		block = new Block();
+		blocks.push_back(block);
+	}
+	else
+	{
+		return 0;
+	}
+
+	block->size = 0;
+
+return block;
+}
+
+
+void BatchPool::Put(Block * block)
+{
+	MutexLock lock(mutex);
+
+	block->seq = next_seq++;
+	++in_progress;
+	queue.push_back(block);
+	work_cond.Signal();
+}
+
+
+BatchPool::Block * BatchPool::GetResult()
+{
+MutexLock lock(mutex);
+std::map<unsigned long, Block*>::iterator i;
+
+	if( in_progress == 0 )
+		return 0;
+
+	while( (i = finished.find(next_result)) == finished.end() )
+		result_cond.Wait(mutex);
+
+	Block * block = i->second;
+	finished.erase(i);
+	++next_result;
+	--in_progress;
+
+return block;
+}
+
+
+void BatchPool::Release(Block * block)
+{
+	free_blocks.push_back(block);
+}
+
+
+unsigned long BatchPool::Expressions() const
+{
+	return expressions;
+}
+
+
+unsigned long BatchPool::Errors() const
+{
+	return errors;
+}
+
+
+void * BatchPool::WorkerThread(void * arg)
+{
+	Worker * worker = reinterpret_cast<Worker*>(arg);
+	worker->pool->WorkerLoop(*worker);
+
+return 0;
+}
+
+
+void BatchPool::WorkerLoop(Worker & worker)
+{
+Block * block;
+
+	mutex.Lock();
+
+	while( true )
+	{
+		while( queue.empty() && !stop )
+			work_cond.Wait(mutex);
+
+		if( stop )
+			break;
+
+		block = queue.front();
+		queue.pop_front();
+		mutex.Unlock();
+
+		// evaluating without the lock
+		block->output.clear();
+
+		for(size_t i=0 ; i<block->size ; ++i)
+			worker.evaluator.Evaluate(block->lines[i], block->output);
+
+		mutex.Lock();
+		finished[block->seq] = block;
+
+		if( block->seq == next_result )
+			result_cond.Signal();
+	}
+
+	mutex.Unlock();
+}
+
@@ -0,0 +1,279 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef headerfilebatchpool
+#define headerfilebatchpool
+
+/*!
+	\file batchpool.h
+    \brief evaluating lines of expressions by many threads
+*/
+
+#include "compileconfig.h"
+#include "evaluator.h"
+#include "threads.h"
+
+#include <ttmath/ttmathobjects.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+
+
+/*!
+	\brief it evaluates one line of input and prints its result
+
+	the object has its own parsers (through Evaluator) and its own copy
+	of variables and functions so many such objects can be used at the same
+	time from different threads (only the languages' object is shared but
+	it's only read)
+*/
+class LineEvaluator
+{
+public:
+
+	LineEvaluator();
+
+
+	/*!
+		the settings, variables and functions are copied
+	*/
+	void Init(const EvaluatorSettings & settings,
+			  const ttmath::Objects & variables,
+			  const ttmath::Objects & functions,
+			  Languages * languages,
+			  bool echo);
+
+
+	/*!
+		evaluating one line, the result and a new line character are appended to 'out'
+
+		an empty line gives an empty line on output (so output lines match input lines),
+		the '\r' character at the end of the line is removed
+	*/
+	void Evaluate(std::string & line, std::string & out);
+
+
+	/*!
+		how many expressions have been evaluated and how many of them had errors
+	*/
+	unsigned long expressions;
+	unsigned long errors;
+
+
+private:
+
+	EvaluatorSettings settings;
+	ttmath::Objects variables;
+	ttmath::Objects functions;
+	Languages * languages;
+	Evaluator evaluator;
+	bool echo;
+	std::string result;
+
+	bool IsEmpty(const std::string & str);
+
+	// the evaluator has pointers to our variables and functions
+	LineEvaluator(const LineEvaluator &);
+	LineEvaluator & operator=(const LineEvaluator &);
+};
+
+
+
+/*!
+	\brief a pool of threads evaluating blocks of lines
+
+	the input is divided into blocks of lines, each block gets a sequence number
+	and is evaluated by the first free worker, results are given back in the same
+	order as blocks were put (there is a reorder buffer for blocks which were
+	finished too early)
+
+	only one thread (the reader) should call GetBlock(), Put(), GetResult() and Release(),
+	the number of blocks is limited so the memory doesn't grow with the size
+	of the input - if GetBlock() returns null then the reader should take a result first
+
+	usage:
+		pool.Start(...);
+
+		while( there is input )
+		{
+			if( !(block = pool.GetBlock()) )
+			{
+				block = pool.GetResult();
+				write block->output
+				pool.Release(block);
+			}
+			else
+			{
+				read lines into block->lines (block->size of them)
+				pool.Put(block);
+			}
+		}
+
+		while( (block = pool.GetResult()) )
+			write block->output and release it
+
+		pool.Stop();
+*/
+class BatchPool
+{
+public:
+
+	/*!
+		how many lines there are in one block
+	*/
+	static const size_t block_lines = 256;
+
+
+	/*!
+		how many blocks there can be for one worker (in the queue, in the reorder buffer
+		and in the reader's hands together)
+	*/
+	static const size_t blocks_per_worker = 4;
+
+
+	struct Block
+	{
+		// only the first 'size' lines are used (strings are reused between blocks)
+		std::vector<std::string> lines;
+		size_t size;
+
+		// results of all lines
+		std::string output;
+
+		unsigned long seq;
+
+		Block();
+	};
+
+
+	BatchPool();
+	~BatchPool();
+
+
+	/*!
+		starting the workers, each worker gets its own copy of variables and functions
+		returning false if the threads could not be created
+	*/
+	bool Start(unsigned int workers,
+			   const EvaluatorSettings & settings,
+			   const ttmath::Objects & variables,
+			   const ttmath::Objects & functions,
+			   Languages * languages,
+			   bool echo);
+
+
+	/*!
+		waiting for the workers and deleting them and all blocks
+		(results which were not taken are lost)
+	*/
+	void Stop();
+
+
+	/*!
+		returning an empty block or null if there are too many blocks in use
+	*/
+	Block * GetBlock();
+
+
+	/*!
+		putting a block to the queue (it will be evaluated by a worker)
+	*/
+	void Put(Block * block);
+
+
+	/*!
+		waiting for the next block in the input order,
+		returning null if there are no blocks which have been put
+	*/
+	Block * GetResult();
+
+
+	/*!
+		giving back the block (from GetBlock() or GetResult())
+	*/
+	void Release(Block * block);
+
+
+	/*!
+		statistics from all workers (valid after Stop())
+	*/
+	unsigned long Expressions() const;
+	unsigned long Errors() const;
+
+
+private:
+
+	struct Worker
+	{
+		BatchPool * pool;
+		pthread_t thread;
+		LineEvaluator evaluator;
+	};
+
+	std::vector<Worker*> workers;
+	std::vector<Block*> blocks;			// all allocated blocks
+	std::vector<Block*> free_blocks;
+	size_t max_blocks;
+
+	// blocks waiting for a worker
+	std::deque<Block*> queue;
+
+	// the reorder buffer: finished blocks waiting for their turn
+	std::map<unsigned long, Block*> finished;
+
+	unsigned long next_seq;		// the number for the next block put
+	unsigned long next_result;	// the number of the block which should be given back next
+	size_t in_progress;			// blocks put but not given back
+
+	bool stop;
+	unsigned long expressions, errors;
+
+	Mutex mutex;
+	Condition work_cond;		// signaled when there is a new block in the queue (or stop)
+	Condition result_cond;		// signaled when the block 'next_result' is finished
+
+	static void * WorkerThread(void * arg);
+	void WorkerLoop(Worker & worker);
+	void DeleteBlocks();
+
+	BatchPool(const BatchPool &);
+	BatchPool & operator=(const BatchPool &);
+};
+
+
+#endif
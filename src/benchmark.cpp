@@ -0,0 +1,856 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*!
+	\file benchmark.cpp
+    \brief micro-benchmarks of the evaluation core (ttcalcbench)
+*/
+
+#include "compileconfig.h"
+#include "evaluator.h"
+#include "compiledexpression.h"
+#include "commandline.h"
+#include "stopflag.h"
+#include "threads.h"
+#include "iniparser.h"
+#include "configjournal.h"
+#include "textfile.h"
+#include "objectssnapshot.h"
+#include "objectslist.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+namespace Benchmark
+{
+EvaluatorSettings settings;
+Languages languages;
+
+// how many times a test is repeated (if it makes sense)
+int repeat = 10;
+
+// expressions for the 'stop' test (given by -x), they should take much more than 50 ms
+std::vector<const char*> long_expressions;
+
+// expressions for the 'levels' test (given by -e)
+std::vector<const char*> level_expressions;
+
+// a formula for the 'compiled' test (given by -c), it uses the variable x
+const char * formula = "x*x + 3*x - sin(x)/2 + sqrt(x)";
+
+
+
+/*!
+	the cost of one poll of the stop object (ttmath does it from its hot loops)
+*/
+void PollCost()
+{
+const size_t polls = 100000000;
+StopFlag flag;
+const volatile ttmath::StopCalculating * stop = &flag;
+size_t stopped = 0;
+
+	double start = CommandLine::GetTime();
+
+	for(size_t i=0 ; i<polls ; ++i)
+		if( stop->WasStopSignal() )
+			++stopped;
+
+	double time = CommandLine::GetTime() - start;
+
+	printf("atomic flag:  %lu polls in %.3f s, %.2f ns per poll\n",
+			(unsigned long)polls, time, time * 1e9 / polls);
+
+#ifdef _WIN32
+
+	// for comparison: the old way - polling a system event
+	const size_t event_polls = 1000000;
+	HANDLE event = CreateEvent(0, true, false, 0);
+
+	if( event )
+	{
+		start = CommandLine::GetTime();
+
+		for(size_t i=0 ; i<event_polls ; ++i)
+			if( WaitForSingleObject(event, 0) == WAIT_OBJECT_0 )
+				++stopped;
+
+		time = CommandLine::GetTime() - start;
+		CloseHandle(event);
+
+		printf("system event: %lu polls in %.3f s, %.2f ns per poll\n",
+				(unsigned long)event_polls, time, time * 1e9 / event_polls);
+	}
+
+#endif
+
+	if( stopped != 0 )
+		printf("(unexpected stop signals: %lu)\n", (unsigned long)stopped);
+}
+
+
+
+struct StopJob
+{
+	Evaluator evaluator;
+	const char * expression;
+	ttmath::ErrorCode code;
+	double end;
+};
+
+
+void * StopJobThread(void * arg)
+{
+	StopJob * job = reinterpret_cast<StopJob*>(arg);
+
+	job->code = job->evaluator.Parse(job->expression, settings);
+	job->end  = CommandLine::GetTime();
+
+return 0;
+}
+
+
+/*!
+	the time from Stop() to the moment when Parse() returns
+	(the calculation is stopped after 'delay' milliseconds)
+*/
+void StopLatency(const char * expression, unsigned int delay)
+{
+StopFlag flag;
+StopJob job;
+pthread_t thread;
+double min = 0.0, max = 0.0, sum = 0.0;
+int count = 0;
+
+	job.evaluator.SetStopObject(&flag);
+	job.evaluator.SetLanguages(&languages);
+	job.expression = expression;
+
+	for(int i=0 ; i<repeat ; ++i)
+	{
+		flag.Start();
+
+		if( !StartThread(thread, StopJobThread, &job) )
+		{
+			printf("I cannot create a thread\n");
+			return;
+		}
+
+		SleepThread(delay);
+		double stop = CommandLine::GetTime();
+		flag.Stop();
+		JoinThread(thread);
+
+		if( job.code == ttmath::err_ok )
+		{
+			printf("%s: the calculation has finished before the stop signal, take a longer one\n", expression);
+			return;
+		}
+
+		if( job.code != ttmath::err_interrupt )
+		{
+			printf("%s: %s\n", expression, languages.ErrorMessage(settings.country, job.code));
+			return;
+		}
+
+		double latency = job.end - stop;
+
+		if( count == 0 || latency < min )
+			min = latency;
+
+		if( count == 0 || latency > max )
+			max = latency;
+
+		sum   += latency;
+		count += 1;
+	}
+
+	if( count > 0 )
+		printf("%s: stop-to-abort latency min %.1f us, avg %.1f us, max %.1f us (%d runs)\n",
+				expression, min * 1e6, sum * 1e6 / count, max * 1e6, count);
+}
+
+
+void StopLatency()
+{
+	if( long_expressions.empty() )
+	{
+		long_expressions.push_back("100000000!");
+		long_expressions.push_back("gamma(100000000)");
+	}
+
+	for(size_t i=0 ; i<long_expressions.size() ; ++i)
+		StopLatency(long_expressions[i], 50);
+}
+
+
+
+/*
+	how many expressions per second are evaluated on the given level
+	(the cache is turned off, each level is run at least 'seconds'),
+	the memory is the estimate of the evaluator for this level after the test
+*/
+void LevelThroughput(int level, double seconds)
+{
+Evaluator evaluator;
+EvaluatorSettings level_settings(settings);
+unsigned long count = 0, errors = 0;
+double time;
+
+	evaluator.SetLanguages(&languages);
+	evaluator.SetCacheSize(0);
+	level_settings.precision = level;
+
+	// the first parsing creates the parser for this level
+	double start = CommandLine::GetTime();
+	evaluator.Parse(level_expressions[0], level_settings);
+	double first = CommandLine::GetTime() - start;
+
+	start = CommandLine::GetTime();
+
+	do
+	{
+		for(size_t i=0 ; i<level_expressions.size() ; ++i, ++count)
+			if( evaluator.Parse(level_expressions[i], level_settings) != ttmath::err_ok )
+				++errors;
+
+		time = CommandLine::GetTime() - start;
+	}
+	while( time < seconds );
+
+	printf("level %d (%4d/%3d bits): %10.0f expressions/s, %8.2f us per expression, first parsing %.1f us, memory %lu bytes",
+			level, ttmath_level_bits[level].mantissa, ttmath_level_bits[level].exponent,
+			count / time, time * 1e6 / count, first * 1e6, (unsigned long)evaluator.MemoryUsage(level));
+
+	if( errors > 0 )
+		printf(", errors: %lu", errors);
+
+	printf("\n");
+}
+
+
+void LevelThroughput()
+{
+	if( level_expressions.empty() )
+	{
+		level_expressions.push_back("1/3 + 1/7 - 2/9");
+		level_expressions.push_back("sqrt(2) * ln(10) + exp(1.5)");
+		level_expressions.push_back("sin(1)^2 + cos(1)^2 - tan(0.3)");
+		level_expressions.push_back("2^0.5 * pi / e");
+		level_expressions.push_back("50!");
+	}
+
+	for(int i=0 ; i<ttmath_levels ; ++i)
+		LevelThroughput(i, 0.05 * repeat);
+}
+
+
+
+/*
+	calculating the formula for x = 1, 2, 3... with the parser (the value of x is
+	changed in the table of variables) and with the compiled form
+*/
+template<class ValueType>
+void CompiledThroughput(const char * name, int level)
+{
+Evaluator evaluator;
+EvaluatorSettings level_settings(settings);
+ttmath::Objects variables, functions;
+CompiledExpression<ValueType> compiled;
+std::vector<std::string> parameters;
+ValueType x, result;
+char buf[30];
+unsigned long i, count = 1000 * repeat;
+
+	level_settings.precision = level;
+	variables.Add("x", "0");
+	evaluator.SetVariables(&variables);
+	evaluator.SetFunctions(&functions);
+	evaluator.SetLanguages(&languages);
+	evaluator.SetCacheSize(0);
+
+	double start = CommandLine::GetTime();
+
+	for(i=1 ; i<=count ; ++i)
+	{
+		sprintf(buf, "%lu", i);
+		variables.EditValue("x", buf);
+		evaluator.Parse(formula, level_settings);
+	}
+
+	double parser_time = CommandLine::GetTime() - start;
+
+	parameters.push_back("x");
+	start = CommandLine::GetTime();
+	ttmath::ErrorCode code = compiled.Compile(formula, parameters, level_settings, &variables, &functions);
+	double compile_time = CommandLine::GetTime() - start;
+
+	if( code != ttmath::err_ok )
+	{
+		printf("%s: the formula cannot be compiled: %s\n", name, languages.ErrorMessage(settings.country, code));
+		return;
+	}
+
+	start = CommandLine::GetTime();
+
+	for(i=1 ; i<=count ; ++i)
+	{
+		x = ttmath::uint(i);
+		compiled.Evaluate(&x, result);
+	}
+
+	double compiled_time = CommandLine::GetTime() - start;
+
+	printf("%s: parser %.2f us, compiled %.2f us per evaluation (%.1fx), compiling %.1f us, %lu instructions\n",
+			name, parser_time * 1e6 / count, compiled_time * 1e6 / count,
+			parser_time / compiled_time, compile_time * 1e6, (unsigned long)compiled.Size());
+}
+
+
+void CompiledThroughput()
+{
+	CompiledThroughput<TTMathBig1>("small ", ttmath_level_small);
+
+	#ifndef TTCALC_PORTABLE
+	CompiledThroughput<TTMathBig2>("medium", ttmath_level_medium);
+	CompiledThroughput<TTMathBig3>("big   ", ttmath_level_big);
+	#endif
+}
+
+
+
+/*
+	the configuration file with 'count' variables and functions
+*/
+void ConfigFill(ttmath::Objects & variables, ttmath::Objects & functions, int count)
+{
+char name[30], value[60];
+
+	for(int i=0 ; i<count ; ++i)
+	{
+		sprintf(name, "var%d", i);
+		sprintf(value, "%d*2 + sin(%d)", i, i);
+		variables.Add(name, value);
+
+		sprintf(name, "fun%d", i);
+		sprintf(value, "x*%d + y", i);
+		functions.Add(name, value, 2);
+	}
+}
+
+
+void ConfigRead(const char * file_name, IniParser::Section & variables, IniParser::Section & functions)
+{
+IniParser iparser;
+
+	iparser.ConvertValueToSmallLetters(false);
+	iparser.SectionCaseSensitive(false);
+	iparser.PatternCaseSensitive(true);
+	iparser.Associate("variables", &variables);
+	iparser.Associate("functions", &functions);
+	iparser.ReadFromFile(file_name);
+}
+
+
+/*
+	how the configuration file was saved before there was the journal
+	(it was read and written again after each change)
+*/
+void ConfigRewrite(const char * file_name, const ttmath::Objects & variables, const ttmath::Objects & functions)
+{
+IniParser::Section temp_variables, temp_functions;
+
+	ConfigRead(file_name, temp_variables, temp_functions);
+	std::ofstream file(file_name);
+	ttmath::Objects::CIterator i;
+
+	file << "[variables]\n";
+
+	for(i = variables.Begin() ; i != variables.End() ; ++i)
+		file << i->first.c_str() << " = " << i->second.value.c_str() << std::endl;
+
+	file << "\n[functions]\n";
+
+	for(i = functions.Begin() ; i != functions.End() ; ++i)
+		file << i->first.c_str() << " = " << i->second.param << " | " << i->second.value.c_str() << std::endl;
+}
+
+
+/*
+	reading the file with the journal and writing it again
+*/
+void ConfigCompact(const char * file_name, ConfigJournal & journal)
+{
+IniParser::Section temp_variables, temp_functions;
+IniParser::Section::iterator ic;
+ttmath::Objects variables, functions;
+std::string temp_file = std::string(file_name) + ".tmp";
+
+	ConfigRead(file_name, temp_variables, temp_functions);
+	journal.Replay(temp_variables, temp_functions);
+
+	for(ic = temp_variables.begin() ; ic != temp_variables.end() ; ++ic)
+		variables.Add(ic->first, ic->second);
+
+	for(ic = temp_functions.begin() ; ic != temp_functions.end() ; ++ic)
+	{
+		// "param | body"
+		size_t bar = ic->second.find('|');
+
+		if( bar != std::string::npos )
+			functions.Add(ic->first, ic->second.substr(bar + 1), atoi(ic->second.c_str()));
+	}
+
+	std::ofstream file(temp_file.c_str());
+	WriteVariablesSection(file, variables);
+	file << '\n';
+	WriteFunctionsSection(file, functions);
+	file.close();
+
+	if( FlushFileToDisk(temp_file) && ReplaceFileAtomically(temp_file, file_name) )
+		journal.Clear();
+}
+
+
+void ConfigLatency(int count)
+{
+static const char file_name[] = "ttcalcbench.ini";
+ttmath::Objects variables, functions;
+ConfigJournal journal;
+char value[30];
+int i, edits = repeat;
+
+	ConfigFill(variables, functions, count);
+	ConfigRewrite(file_name, variables, functions);
+	journal.SetFileName(file_name);
+	journal.Clear();
+
+	double start = CommandLine::GetTime();
+
+	for(i=0 ; i<edits ; ++i)
+	{
+		sprintf(value, "%d", i);
+		variables.EditValue("var0", value);
+		ConfigRewrite(file_name, variables, functions);
+	}
+
+	double rewrite_time = (CommandLine::GetTime() - start) / edits;
+
+	// appending is much faster so we're doing more edits
+	// (but not more than the journal takes)
+	edits = int(ConfigJournal::max_records) - 1;
+	start = CommandLine::GetTime();
+
+	for(i=0 ; i<edits ; ++i)
+	{
+		sprintf(value, "%d", i);
+		variables.EditValue("var0", value);
+		journal.SetVariable("var0", value);
+	}
+
+	double journal_time = (CommandLine::GetTime() - start) / edits;
+
+	start = CommandLine::GetTime();
+	ConfigCompact(file_name, journal);
+	double compact_time = CommandLine::GetTime() - start;
+
+	printf("%6d variables and functions: rewriting %.2f ms, journal %.3f ms per edit (%.0fx), compacting %.2f ms\n",
+			count, rewrite_time * 1e3, journal_time * 1e3, rewrite_time / journal_time, compact_time * 1e3);
+
+	remove(file_name);
+	remove(journal.GetFileName().c_str());
+}
+
+
+void ConfigLatency()
+{
+	ConfigLatency(1000);
+	ConfigLatency(10000);
+	ConfigLatency(100000);
+}
+
+
+
+/*
+	changing a variable while the list on the variables' tab holds a snapshot
+	of the table (the table is shared and it is copied by each change)
+	and when the list releases the snapshot before the change
+*/
+void EditVariable(ObjectsSnapshot & variables, ObjectsList & list, bool release, int edits, double & time, int & copies)
+{
+char value[30];
+
+	copies = 0;
+	double start = CommandLine::GetTime();
+
+	for(int i=0 ; i<edits ; ++i)
+	{
+		sprintf(value, "%d", i);
+
+		if( release )
+			list.Reset();
+
+		// the list holds the old table until SetObjects() so a copy has another address
+		const ttmath::Objects * table = variables.Get();
+		variables.Change()->EditValue("var0", value);
+
+		if( variables.Get() != table )
+			++copies;
+
+		list.SetObjects(variables);
+	}
+
+	time = (CommandLine::GetTime() - start) / edits;
+}
+
+
+void EditLatency(int count)
+{
+ObjectsSnapshot variables;
+ObjectsList list;
+char name[30];
+double held_time, released_time;
+int held_copies, released_copies;
+
+	for(int i=0 ; i<count ; ++i)
+	{
+		sprintf(name, "var%d", i);
+		variables.Change()->Add(name, "1");
+	}
+
+	list.SetObjects(variables);
+
+	EditVariable(variables, list, false, repeat, held_time,     held_copies);
+	EditVariable(variables, list, true,  repeat, released_time, released_copies);
+
+	printf("%7d variables: list holding the table %.3f ms per edit (%d copies), released %.3f ms per edit (%d copies)\n",
+			count, held_time * 1e3, held_copies, released_time * 1e3, released_copies);
+}
+
+
+void EditLatency()
+{
+	EditLatency(1000);
+	EditLatency(100000);
+	EditLatency(1000000);
+}
+
+
+/*
+	how the pad was loading files before: chunks of 63 bytes appended to a string
+	and then '\r' inserted before each single '\n' (quadratic for unix files)
+*/
+void LoadOld(const char * file_name, std::string & text)
+{
+std::ifstream file(file_name, std::ios_base::in | std::ios_base::binary);
+char buf[64];
+std::streamsize size;
+bool was_r = false;
+
+	text.clear();
+
+	do
+	{
+		file.read(buf, sizeof(buf)-1);
+
+		size = file.gcount();
+		buf[size] = 0;
+		text += buf;
+	}
+	while( !file.eof() );
+
+	for(size_t i=0 ; i<text.size() ; ++i)
+	{
+		if( text[i]==10 && !was_r )
+		{
+			text.insert(text.begin()+i, 13);
+			++i;
+		}
+		else
+		{
+			was_r = text[i] == 13;
+		}
+	}
+}
+
+
+void LoadNew(const char * file_name, std::string & text)
+{
+TextFile file;
+
+	if( file.Open(file_name) )
+		file.Read(text, "\r\n");
+}
+
+
+/*
+	a file of about 'size' bytes, lines have new lines given by 'new_line'
+	("mixed" means that they are taken in turn from "\n", "\r\n" and "\r")
+*/
+bool LoadCreate(const char * file_name, size_t size, const char * new_line)
+{
+std::ofstream file(file_name, std::ios_base::out | std::ios_base::binary);
+static const char * mixed[] = { "\n", "\r\n", "\r" };
+char line[60];
+size_t written = 0;
+
+	for(unsigned long i=0 ; written < size ; ++i)
+	{
+		const char * nl = (strcmp(new_line, "mixed") == 0) ? mixed[i % 3] : new_line;
+		int len = sprintf(line, "x%lu = sin(%lu) * 2.5 + x%lu%s", i % 100, i, (i + 1) % 100, nl);
+		file.write(line, len);
+		written += len;
+	}
+
+return bool(file);
+}
+
+
+void LoadTime(const char * file_name, void (*load)(const char*, std::string&), int count, double & time, size_t & text_size)
+{
+std::string text;
+
+	double start = CommandLine::GetTime();
+
+	for(int i=0 ; i<count ; ++i)
+		load(file_name, text);
+
+	time      = (CommandLine::GetTime() - start) / count;
+	text_size = text.size();
+}
+
+
+void LoadFile()
+{
+static const char file_name[] = "ttcalcbench.txt";
+static const size_t sizes[] = { 64*1024, 256*1024, 1024*1024, 10*1024*1024, 50*1024*1024 };
+static const char * new_lines[] = { "\n", "\r\n", "mixed" };
+static const char * styles[] = { "lf", "crlf", "mixed" };
+
+// the old way takes minutes for bigger files
+const size_t max_old_size = 256*1024;
+
+	for(size_t s=0 ; s<sizeof(sizes)/sizeof(size_t) ; ++s)
+	{
+		for(size_t n=0 ; n<sizeof(new_lines)/sizeof(const char*) ; ++n)
+		{
+			double new_time, old_time;
+			size_t new_size, old_size;
+
+			if( !LoadCreate(file_name, sizes[s], new_lines[n]) )
+			{
+				printf("the file %s cannot be written\n", file_name);
+				remove(file_name);
+				return;
+			}
+
+			LoadTime(file_name, LoadNew, repeat, new_time, new_size);
+			printf("%6lu KB %-5s: mapped %8.2f ms (%.0f MB/s)", (unsigned long)(sizes[s] / 1024), styles[n],
+					new_time * 1e3, sizes[s] / new_time / (1024*1024));
+
+			if( sizes[s] <= max_old_size )
+			{
+				LoadTime(file_name, LoadOld, 1, old_time, old_size);
+				printf(", chunks %8.2f ms (%.0fx)", old_time * 1e3, old_time / new_time);
+
+				// the old way doesn't know single '\r'
+				if( old_size != new_size && n != 2 )
+					printf(" - different sizes of the text!");
+			}
+
+			printf("\n");
+		}
+	}
+
+	remove(file_name);
+}
+
+
+
+struct Test
+{
+	const char * name;
+	const char * description;
+	void (*fun)();
+};
+
+
+Test tests[] = {
+	{ "poll", "the cost of polling the stop object",                 PollCost },
+	{ "stop", "stop-to-abort latency of long factorial/gamma calls", StopLatency },
+	{ "levels", "throughput of each level of the precision ladder",  LevelThroughput },
+	{ "compiled", "a formula calculated by the parser and compiled", CompiledThroughput },
+	{ "config", "saving a change of a variable in a configuration file", ConfigLatency },
+	{ "load", "loading a pad file (unix, windows and mixed new lines)", LoadFile },
+	{ "edit", "changing a variable while the list of variables is shown", EditLatency },
+	{ 0, 0, 0 }
+};
+
+
+void PrintUsage()
+{
+	fprintf(stderr,
+		"usage: ttcalcbench [options] [test...]\n"
+		"without tests given all of them are run\n\n"
+		"  -n count       repeat a test 'count' times (default: 10)\n"
+		"                 (the 'levels' test runs 'count' * 50 ms on each level)\n"
+		"  -x expression  a long expression for the 'stop' test (can be given more times)\n"
+		"  -e expression  an expression for the 'levels' test (can be given more times)\n"
+		"  -c formula     a formula with x for the 'compiled' test\n");
+
+	CommandLine::PrintSettingsOptions(stderr);
+
+	fprintf(stderr, "\ntests:\n");
+
+	for(int i=0 ; tests[i].name ; ++i)
+		fprintf(stderr, "  %-14s %s\n", tests[i].name, tests[i].description);
+}
+
+
+Test * FindTest(const char * name)
+{
+	for(int i=0 ; tests[i].name ; ++i)
+		if( strcmp(tests[i].name, name) == 0 )
+			return &tests[i];
+
+return 0;
+}
+
+
+/*!
+	returning false if the program should finish
+*/
+bool ReadArguments(int argc, char ** argv, std::vector<Test*> & run)
+{
+bool error;
+
+	for(int i=1 ; i<argc ; ++i)
+	{
+		if( CommandLine::ReadSettingsOption(argc, argv, i, settings, error) )
+		{
+			if( error )
+			{
+				fprintf(stderr, "ttcalcbench: a value for %s is missing\n", argv[i]);
+				return false;
+			}
+		}
+		else
+		if( strcmp(argv[i], "-n") == 0 && i+1<argc )
+		{
+			repeat = atoi(argv[++i]);
+
+			if( repeat < 1 )
+				repeat = 1;
+		}
+		else
+		if( strcmp(argv[i], "-x") == 0 && i+1<argc )
+		{
+			long_expressions.push_back(argv[++i]);
+		}
+		else
+		if( strcmp(argv[i], "-e") == 0 && i+1<argc )
+		{
+			level_expressions.push_back(argv[++i]);
+		}
+		else
+		if( strcmp(argv[i], "-c") == 0 && i+1<argc )
+		{
+			formula = argv[++i];
+		}
+		else
+		if( argv[i][0] == '-' )
+		{
+			PrintUsage();
+			return false;
+		}
+		else
+		{
+			Test * test = FindTest(argv[i]);
+
+			if( !test )
+			{
+				fprintf(stderr, "ttcalcbench: there is no such a test: %s\n", argv[i]);
+				return false;
+			}
+
+			run.push_back(test);
+		}
+	}
+
+return true;
+}
+
+
+} // namespace Benchmark
+
+
+
+int main(int argc, char ** argv)
+{
+using namespace Benchmark;
+
+std::vector<Test*> run;
+
+	if( !ReadArguments(argc, argv, run) )
+		return 2;
+
+	languages.InitAll();
+	languages.SetCurrentLanguage(Languages::en);
+
+	if( run.empty() )
+		for(int i=0 ; tests[i].name ; ++i)
+			run.push_back(&tests[i]);
+
+	for(size_t i=0 ; i<run.size() ; ++i)
+	{
+		printf("[%s]\n", run[i]->name);
+		run[i]->fun();
+		printf("\n");
+	}
+
+return 0;
+}
+
@@ -51,6 +51,16 @@
 #endif
 
 
+/*
+	the precision ladder
+
+	all types which can be used for calculating are declared here only once:
+	LEVEL(level, minimum bits for the exponent, minimum bits for the mantissa)
+
+	a level is selected at runtime (EvaluatorSettings::precision), the evaluator
+	creates a parser for a level when the level is used for the first time
+	(so a level which is not used costs only the code)
+*/
 #ifndef TTCALC_PORTABLE
 
 	/*
@@ -58,31 +68,106 @@
 	ttmath::Big<1,3>
 	ttmath::Big<2,6>
 	ttmath::Big<3,9>
-	*/
 
-	/*
-	typedef ttmath::Big<1,3>  TTMathBig1;
-	typedef ttmath::Big<2,9>  TTMathBig2;
-	typedef ttmath::Big<4,27> TTMathBig3;
-	typedef TTMathBig3        TTMathBigMax;
+	ttmath::Big<1,3>
+	ttmath::Big<2,9>
+	ttmath::Big<4,27>
 	*/
 
-	typedef ttmath::Big<TTMATH_BITS(32),  TTMATH_BITS(96)  > TTMathBig1;
-	typedef ttmath::Big<TTMATH_BITS(64),  TTMATH_BITS(512) > TTMathBig2;
-	typedef ttmath::Big<TTMATH_BITS(128), TTMATH_BITS(1024)> TTMathBig3;
-	typedef TTMathBig3 TTMathBigMax;
+	#define TTCALC_PRECISION_LADDER(LEVEL) \
+		LEVEL(0,  32,   96) \
+		LEVEL(1,  32,  128) \
+		LEVEL(2,  64,  256) \
+		LEVEL(3,  64,  512) \
+		LEVEL(4, 128, 1024) \
+		LEVEL(5, 128, 2048) \
+		LEVEL(6, 128, 4096)
+
+	// levels used by the precision tab (small, medium, big)
+	const int ttmath_level_small  = 0;
+	const int ttmath_level_medium = 3;
+	const int ttmath_level_big    = 4;
 
 #else
 	
 	/* portable */
 
-	typedef ttmath::Big<TTMATH_BITS(32), TTMATH_BITS(96)> TTMathBig1;
-	typedef TTMathBig1 TTMathBigMax;
+	#define TTCALC_PRECISION_LADDER(LEVEL) \
+		LEVEL(0,  32,   96)
+
+	const int ttmath_level_small  = 0;
+	const int ttmath_level_medium = 0;
+	const int ttmath_level_big    = 0;
 
 #endif
 
 
 
+/*!
+	TTMathLevel<level>::Type is the type used for calculating on the given level
+*/
+template<int level>
+struct TTMathLevel
+{
+};
+
+
+#define TTCALC_LADDER_TYPE(level, exponent_bits, mantissa_bits) \
+	template<> \
+	struct TTMathLevel<level> \
+	{ \
+		typedef ttmath::Big<TTMATH_BITS(exponent_bits), TTMATH_BITS(mantissa_bits)> Type; \
+	};
+
+TTCALC_PRECISION_LADDER(TTCALC_LADDER_TYPE)
+
+
+/*!
+	the minimum bits of each level (the real ones are rounded up to the size of a machine word)
+*/
+struct TTMathLevelBits
+{
+	int exponent;
+	int mantissa;
+};
+
+#define TTCALC_LADDER_BITS(level, exponent_bits, mantissa_bits) \
+	{ exponent_bits, mantissa_bits },
+
+static const TTMathLevelBits ttmath_level_bits[] = {
+	TTCALC_PRECISION_LADDER(TTCALC_LADDER_BITS)
+};
+
+// how many levels there are
+const int ttmath_levels = sizeof(ttmath_level_bits) / sizeof(TTMathLevelBits);
+
+
+/*!
+	returning the level for the precision from the precision tab
+	(0 - small, 1 - medium, 2 - big)
+*/
+inline int TTMathPrecisionLevel(int precision)
+{
+	if( precision <= 0 )
+		return ttmath_level_small;
+
+	if( precision == 1 )
+		return ttmath_level_medium;
+
+return ttmath_level_big;
+}
+
+
+typedef TTMathLevel<ttmath_level_small>::Type  TTMathBig1;
+typedef TTMathLevel<ttmath_level_medium>::Type TTMathBig2;
+typedef TTMathLevel<ttmath_level_big>::Type    TTMathBig3;
+
+// used for the units of the converting (they don't need more than the big precision)
+typedef TTMathBig3 TTMathBigMax;
+
+
+
+
 
 
 #endif
@@ -40,6 +40,43 @@
 #include "tabs.h"
 #include <process.h>
 
+/*!
+	it returns a free slot in the queue of results
+
+	if the queue is full we're waiting for the gui to take something,
+	null is returned if there was a stop signal in the meantime
+*/
+CalculationResult * NewResult()
+{
+ResultQueue * queue = GetPrgRes()->GetResultQueue();
+CalculationResult * result;
+
+	while( (result = queue->Back()) == 0 )
+	{
+		if( GetPrgRes()->GetThreadController()->WasStopSignal() )
+			return 0;
+
+		Sleep(1);
+	}
+
+	result->generation = GetPrgRes()->GetThreadController()->GetJobGeneration();
+
+return result;
+}
+
+
+/*!
+	it gives the result from NewResult() to the gui
+	(only one message is posted even if the gui has not taken older results yet)
+*/
+void PublishResult(HWND main_window)
+{
+	if( GetPrgRes()->GetResultQueue()->Push() )
+		PostMessage(main_window, WM_SET_RESULT, 0, 0);
+}
+
+
+
 /*!
 	the function for the second thread
 */
@@ -48,8 +85,12 @@ unsigned __stdcall CalculationsProcedure(void *)
 	ParserManager parser_manager;
 	parser_manager.Init();
 
+	volatile ThreadController * thread_controller = GetPrgRes()->GetThreadController();
+	CalculationResult * result;
+	std::string convert_info;
+
 	// the main loop of calculations
-	while( GetPrgRes()->GetThreadController()->WaitForCalculatingAndBlockForStop() )
+	while( thread_controller->WaitForCalculatingAndBlockForStop() )
 	{
 		HWND main_window = GetPrgRes()->GetMainWindow();
 
@@ -58,29 +99,75 @@ unsigned __stdcall CalculationsProcedure(void *)
 		parser_manager.MakeCopyOfVariables();
 		
 		// then we can set 'thread_controller' as being ready for the 'stop' signal
-		GetPrgRes()->GetThreadController()->ReadyForStop();
+		thread_controller->ReadyForStop();
 		// (now the main thread can call various methods for changing the state)
 
-		// and we're cleaning the output edit and sending a message about calculating 
-		SetDlgItemText(main_window, IDC_OUTPUT_EDIT, "");
-		PostMessage(main_window, WM_SET_LAST_ERROR, (WPARAM)ttmath::err_still_calculating, 0);
+		// we were woken up more than once for the same input
+		// (the snapshots are released so the gui can change the tables without copying)
+		if( !thread_controller->IsNewJob() )
+		{
+			parser_manager.ReleaseVariables();
+			continue;
+		}
 
-		// we're showing info about converting
-		parser_manager.ShowConvertingInfo();
+		// the user has typed something more in the meantime,
+		// the newer input is already waiting for us
+		if( thread_controller->IsJobStale() )
+		{
+			parser_manager.ReleaseVariables();
+			thread_controller->CountJob(ThreadController::job_discarded);
+			continue;
+		}
+
+		// we're printing info about converting
+		parser_manager.PrintConvertingInfo(convert_info);
+
+		// and we're cleaning the output edit and sending a message about calculating
+		if( (result = NewResult()) != 0 )
+		{
+			result->code = ttmath::err_still_calculating;
+			result->output.erase();
+			result->convert_info = convert_info;
+			PublishResult(main_window);
+		}
+
+		thread_controller->CountJob(ThreadController::job_started);
+
+		// in the progressive mode we're showing a result from the smallest precision first,
+		// it's marked as provisional and the code is still err_still_calculating
+		if( parser_manager.ParseProvisional() &&
+			!thread_controller->WasStopSignal() && (result = NewResult()) != 0 )
+		{
+			parser_manager.PrintResult(result->output);
+
+			if( !result->output.empty() )
+				result->output.insert(0, "~ ");
+
+			result->code = ttmath::err_still_calculating;
+			result->convert_info = convert_info;
+			PublishResult(main_window);
+		}
 
 		// and finally we're parsing the input string
+		// (if there was a stop signal the parsing is interrupted at once)
 		parser_manager.Parse();
 
-		// after parsing we're sending a message about the result of parsing
-		PostMessage(main_window, WM_SET_LAST_ERROR, (WPARAM)parser_manager.GetLastCode(), 0);
-
-		// at the end we're printing the result
 		// if there was a stop signal we continue the main loop without printing any values
-		if( ! GetPrgRes()->GetThreadController()->WasStopSignal() )
-			if( parser_manager.PrintResult() )
-				PostMessage(main_window, WM_SET_LAST_ERROR, (WPARAM)parser_manager.GetLastCode(), 0);
+		if( thread_controller->WasStopSignal() || (result = NewResult()) == 0 )
+		{
+			thread_controller->CountJob(ThreadController::job_cancelled);
+			continue;
+		}
 
+		// at the end we're giving the result and the code of parsing to the gui
+		parser_manager.PrintResult(result->output);
+		result->code = parser_manager.GetLastCode();
+		result->convert_info = convert_info;
+		PublishResult(main_window);
 
+		// only now, a job which was stopped is parsed again at the next waking up
+		thread_controller->JobDone();
+		thread_controller->CountJob(ThreadController::job_completed);
 	}
 
 
@@ -0,0 +1,332 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "compileconfig.h"
+#include "commandline.h"
+#include "configjournal.h"
+#include <cstring>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+
+
+namespace CommandLine
+{
+
+
+/*!
+	splitting a value of a function from the configuration file
+	(the value is in the form: "number_of_parameters | body")
+*/
+bool SplitFunction(const std::string & input, std::string & body, int & param)
+{
+const char * pchar = input.c_str();
+
+	while( *pchar==' ' || *pchar=='\t' )
+		++pchar;
+
+	param = atoi(pchar);
+
+	if( param < 0 )
+		param = 0;
+	else
+	if( param > 9 )
+		param = 9;
+
+	while( *pchar>='0' && *pchar<='9' )
+		++pchar;
+
+	while( *pchar==' ' || *pchar=='\t' )
+		++pchar;
+
+	if( *pchar != '|' )
+		return false;
+
+	++pchar;
+
+	while( *pchar==' ' || *pchar=='\t' )
+		++pchar;
+
+	body = pchar;
+
+return true;
+}
+
+
+
+IniParser::Error ReadVariablesFunctions(const char * file_name,
+										ttmath::Objects & variables,
+										ttmath::Objects & functions,
+										int * bad_line)
+{
+IniParser iparser;
+IniParser::Section temp_variables, temp_functions;
+IniParser::Section::iterator ic;
+ConfigJournal journal;
+std::string body;
+int param;
+
+	iparser.ConvertValueToSmallLetters(false);
+	iparser.SectionCaseSensitive(false);
+
+	// we have variables and functions case-sensitive
+	iparser.PatternCaseSensitive(true);
+
+	iparser.Associate( "variables", &temp_variables );
+	iparser.Associate( "functions", &temp_functions );
+
+	IniParser::Error err = iparser.ReadFromFile(file_name);
+
+	if( err == IniParser::err_cant_open_file )
+		return err;
+
+	if( err != IniParser::err_ok && bad_line )
+		*bad_line = iparser.GetBadLine();
+
+	// variables and functions changed since the file was written
+	journal.SetFileName(file_name);
+	journal.Replay(temp_variables, temp_functions);
+
+	for( ic = temp_variables.begin() ; ic!=temp_variables.end() ; ++ic )
+		variables.Add(ic->first, ic->second);
+
+	for( ic = temp_functions.begin() ; ic!=temp_functions.end() ; ++ic )
+		if( SplitFunction(ic->second, body, param) )
+			functions.Add(ic->first, body, param);
+
+return err;
+}
+
+
+
+/*!
+	reading an integer value of an option
+*/
+bool ReadInt(int argc, char ** argv, int & i, int & value, bool & error)
+{
+	if( i+1 >= argc )
+	{
+		error = true;
+		return true;
+	}
+
+	value = atoi(argv[++i]);
+
+return true;
+}
+
+
+/*!
+	reading a character value of an option
+	("none" or an empty string means no character)
+*/
+bool ReadChar(int argc, char ** argv, int & i, char & value, bool & error)
+{
+	if( i+1 >= argc )
+	{
+		error = true;
+		return true;
+	}
+
+	++i;
+
+	if( strcmp(argv[i], "none") == 0 )
+		value = 0;
+	else
+		value = argv[i][0];
+
+return true;
+}
+
+
+int Clamp(int value, int min, int max)
+{
+	if( value < min )
+		value = min;
+
+	if( value > max )
+		value = max;
+
+return value;
+}
+
+
+
+bool ReadSettingsOption(int argc, char ** argv, int & i, EvaluatorSettings & settings, bool & error)
+{
+const char * opt = argv[i];
+bool res = false;
+int value = 0;	// ReadInt() doesn't set it when the value is missing
+
+	error = false;
+
+	if( strcmp(opt, "-p") == 0 )
+	{
+		res = ReadInt(argc, argv, i, value, error);
+		settings.precision = TTMathPrecisionLevel(Clamp(value, 0, 2));
+	}
+	else
+	if( strcmp(opt, "-l") == 0 )
+	{
+		res = ReadInt(argc, argv, i, value, error);
+		settings.precision = Clamp(value, 0, ttmath_levels-1);
+	}
+	else
+	if( strcmp(opt, "-i") == 0 )
+	{
+		res = ReadInt(argc, argv, i, value, error);
+		settings.base_input = Clamp(value, 2, 16);
+	}
+	else
+	if( strcmp(opt, "-o") == 0 )
+	{
+		res = ReadInt(argc, argv, i, value, error);
+		settings.base_output = Clamp(value, 2, 16);
+	}
+	else
+	if( strcmp(opt, "-r") == 0 )
+	{
+		res = ReadInt(argc, argv, i, value, error);
+		settings.rounding = Clamp(value, -1, 99);
+	}
+	else
+	if( strcmp(opt, "-w") == 0 )
+	{
+		res = ReadInt(argc, argv, i, value, error);
+		settings.when_scientific = Clamp(value, 1, 99);
+	}
+	else
+	if( strcmp(opt, "-a") == 0 )
+	{
+		res = ReadInt(argc, argv, i, value, error);
+		settings.angle_deg_rad_grad = Clamp(value, 0, 2);
+	}
+	else
+	if( strcmp(opt, "-gd") == 0 )
+	{
+		res = ReadInt(argc, argv, i, value, error);
+		settings.grouping_digits = Clamp(value, 1, 9);
+	}
+	else
+	if( strcmp(opt, "-g") == 0 )
+	{
+		res = ReadChar(argc, argv, i, settings.grouping, error);
+	}
+	else
+	if( strcmp(opt, "-d") == 0 )
+	{
+		res = ReadChar(argc, argv, i, settings.decimal_point, error);
+	}
+	else
+	if( strcmp(opt, "-s") == 0 )
+	{
+		settings.always_scientific = true;
+		res = true;
+	}
+	else
+	if( strcmp(opt, "-z") == 0 )
+	{
+		settings.remove_zeroes = false;
+		res = true;
+	}
+	else
+	if( strcmp(opt, "-f") == 0 )
+	{
+		settings.fast_path = true;
+		res = true;
+	}
+
+return res;
+}
+
+
+void PrintSettingsOptions(FILE * out)
+{
+	fprintf(out,
+		"  -p precision   0 - small, 1 - medium, 2 - big (default 0)\n"
+		"  -l level       a level of the precision ladder 0-%d (instead of -p):\n",
+		ttmath_levels-1);
+
+	for(int i=0 ; i<ttmath_levels ; ++i)
+		fprintf(out, "                 %d - %d bits for the mantissa, %d bits for the exponent\n",
+				i, ttmath_level_bits[i].mantissa, ttmath_level_bits[i].exponent);
+
+	fprintf(out,
+		"  -i base        the base of input values 2-16 (default 10)\n"
+		"  -o base        the base of output values 2-16 (default 10)\n"
+		"  -r digits      rounding -1 (none) - 99 (default -1)\n"
+		"  -s             always use the scientific format\n"
+		"  -w exponent    use the scientific format when the exponent is greater (default 8)\n"
+		"  -z             don't remove trailing zeroes\n"
+		"  -f             calculate simple arithmetic on doubles when the printed\n"
+		"                 digits can be proven (integers, or rounding set by -r)\n"
+		"  -a angle       0 - deg, 1 - rad, 2 - grad (default 1)\n"
+		"  -d char        the decimal point used when printing (default '.')\n"
+		"  -g char        the grouping character or 'none' (default none)\n"
+		"  -gd digits     how many digits should be grouped 1-9 (default 3)\n");
+}
+
+
+double GetTime()
+{
+#ifdef _WIN32
+
+	LARGE_INTEGER freq, count;
+
+	if( !QueryPerformanceFrequency(&freq) || !QueryPerformanceCounter(&count) )
+		return GetTickCount() / 1000.0;
+
+	return double(count.QuadPart) / double(freq.QuadPart);
+
+#else
+
+	struct timeval tv;
+	gettimeofday(&tv, 0);
+
+	return double(tv.tv_sec) + double(tv.tv_usec) / 1000000.0;
+
+#endif
+}
+
+
+} // namespace CommandLine
+
@@ -0,0 +1,94 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef headerfilecommandline
+#define headerfilecommandline
+
+/*!
+	\file commandline.h
+    \brief some helpers used by the command line front ends (they don't use the win32 api)
+*/
+
+#include "compileconfig.h"
+#include "evaluator.h"
+#include "iniparser.h"
+
+#include <ttmath/ttmathobjects.h>
+#include <cstdio>
+
+
+namespace CommandLine
+{
+
+	/*!
+		reading the [variables] and [functions] sections from a configuration file of ttcalc
+		(the same as ProgramResources::ReadFromFile() does but other sections are skipped),
+		changes from the journal of the file are applied too
+
+		if there was an error with a line then 'bad_line' is set (if not null)
+	*/
+	IniParser::Error ReadVariablesFunctions(const char * file_name,
+											ttmath::Objects & variables,
+											ttmath::Objects & functions,
+											int * bad_line = 0);
+
+
+	/*!
+		if argv[i] is an option which describes the evaluator settings then the option
+		is read into 'settings' and true is returned ('i' is incremented if the option has a value)
+
+		'error' is set to true if the value of the option is missing
+	*/
+	bool ReadSettingsOption(int argc, char ** argv, int & i, EvaluatorSettings & settings, bool & error);
+
+
+	/*!
+		printing the description of options read by ReadSettingsOption()
+	*/
+	void PrintSettingsOptions(FILE * out);
+
+
+	/*!
+		returning the time in seconds (from an unspecified point)
+		it's used for measuring how long the evaluation has taken
+	*/
+	double GetTime();
+
+}
+
+
+#endif
@@ -0,0 +1,866 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef headerfilecompiledexpression
+#define headerfilecompiledexpression
+
+/*!
+	\file compiledexpression.h
+    \brief an expression compiled into a postfix program for repeated evaluation
+*/
+
+#include "compileconfig.h"
+#include "evaluator.h"
+#include <ttmath/ttmathobjects.h>
+#include <string>
+#include <vector>
+
+
+/*!
+	\brief an expression compiled into a postfix program
+
+	ttmath::Parser reads the string each time Parse() is called, when the same formula
+	is calculated many times with different values of some variables (e.g. a table
+	of a function) we can read the string only once: Compile() makes a program for
+	a simple stack machine and Evaluate() runs it with values of the parameters
+
+	the parameters are given by names when compiling and their values are given
+	by the same order to Evaluate(), other names are taken from the tables of
+	variables and functions (the same ones ParserManager copies): a user-defined
+	variable is compiled from its value and a user-defined function is compiled
+	inline with its arguments
+
+	recognized are: numbers (read by ValueType::FromString() with the base and
+	the commas from the settings), operators + - * / ^, unary minus, brackets,
+	constants pi and e and functions sin, cos, tan, asin, acos, atan, ln, log,
+	exp, sqrt and abs, other things make Compile() fail and such an expression
+	should be calculated by the parser (Compile() is not a full replacement for it,
+	a few constructions which could be read differently by the parser are rejected
+	too: a^b^c, -a^b and a^-b)
+
+	Evaluate() uses a stack kept in the object so one object should be used
+	only by one thread at a time (copies of a compiled object are independent
+	and can be given to other threads)
+*/
+template<class ValueType>
+class CompiledExpression
+{
+public:
+
+	CompiledExpression()
+	{
+		compiled   = false;
+		stack_size = 0;
+		angle      = 1;
+	}
+
+
+	/*!
+		compiling the string
+
+		'parameters' are names of values given to Evaluate(), 'variables' and 'functions'
+		are the user-defined tables (can be null), they are used only during compiling
+	*/
+	ttmath::ErrorCode Compile(const char * str,
+							  const std::vector<std::string> & pparameters,
+							  const EvaluatorSettings & psettings,
+							  const ttmath::Objects * pvariables,
+							  const ttmath::Objects * pfunctions)
+	{
+		program.clear();
+		constants.clear();
+		frames.clear();
+		compiled   = false;
+		stack_size = 0;
+
+		pchar      = str;
+		parameters = &pparameters;
+		settings   = &psettings;
+		variables  = pvariables;
+		functions  = pfunctions;
+		depth      = 0;
+		angle      = psettings.angle_deg_rad_grad;
+
+		conv.base  = psettings.base_input;
+		conv.comma = (unsigned char)psettings.input_comma1;
+		conv.comma2= (unsigned char)psettings.input_comma2;
+		conv.group = (unsigned char)psettings.grouping;
+
+		// other bases can have letters as digits
+		if( psettings.base_input > 10 )
+			return ttmath::err_unknown_character;
+
+		SkipWhite();
+
+		if( *pchar == 0 )
+			return ttmath::err_nothing_has_read;
+
+		ttmath::ErrorCode code = Expression();
+
+		if( code == ttmath::err_ok )
+		{
+			SkipWhite();
+
+			if( *pchar != 0 )
+				code = ttmath::err_unknown_character;
+		}
+
+		if( code != ttmath::err_ok )
+		{
+			program.clear();
+			constants.clear();
+			return code;
+		}
+
+		stack_size = StackSize();
+		stack.resize(stack_size);
+		compiled = true;
+
+	return ttmath::err_ok;
+	}
+
+
+	bool IsCompiled() const
+	{
+		return compiled;
+	}
+
+
+	/*!
+		how many instructions the program has
+	*/
+	size_t Size() const
+	{
+		return program.size();
+	}
+
+
+	/*!
+		running the program, 'bindings' are values of the parameters
+		(in the same order as names given to Compile())
+	*/
+	ttmath::ErrorCode Evaluate(const ValueType * bindings, ValueType & result)
+	{
+	size_t sp = 0;
+	ttmath::ErrorCode err = ttmath::err_ok;
+
+		if( !compiled )
+			return ttmath::err_internal_error;
+
+		for(size_t i=0 ; i<program.size() ; ++i)
+		{
+			const Instruction & ins = program[i];
+
+			switch( ins.op )
+			{
+			case op_constant:
+				stack[sp++] = constants[ins.index];
+				break;
+
+			case op_binding:
+				stack[sp++] = bindings[ins.index];
+				break;
+
+			case op_neg:
+				stack[sp-1].ChangeSign();
+				break;
+
+			case op_add:
+				--sp;
+				if( stack[sp-1].Add(stack[sp]) )
+					return ttmath::err_overflow;
+				break;
+
+			case op_sub:
+				--sp;
+				if( stack[sp-1].Sub(stack[sp]) )
+					return ttmath::err_overflow;
+				break;
+
+			case op_mul:
+				--sp;
+				if( stack[sp-1].Mul(stack[sp]) )
+					return ttmath::err_overflow;
+				break;
+
+			case op_div:
+				--sp;
+				if( stack[sp].IsZero() )
+					return ttmath::err_division_by_zero;
+
+				if( stack[sp-1].Div(stack[sp]) )
+					return ttmath::err_overflow;
+				break;
+
+			case op_pow:
+				--sp;
+				switch( stack[sp-1].Pow(stack[sp]) )
+				{
+				case 0:
+					break;
+
+				case 1:
+					return ttmath::err_overflow;
+
+				default:
+					return ttmath::err_improper_argument;
+				}
+				break;
+
+			case op_log:
+				--sp;
+				stack[sp-1] = ttmath::Log(stack[sp-1], stack[sp], &err);
+				break;
+
+			default:
+				err = Function(ins.op, stack[sp-1]);
+				break;
+			}
+
+			if( err != ttmath::err_ok )
+				return err;
+		}
+
+		result = stack[0];
+
+	return ttmath::err_ok;
+	}
+
+
+	ttmath::ErrorCode Evaluate(const std::vector<ValueType> & bindings, ValueType & result)
+	{
+		return Evaluate(bindings.empty() ? 0 : &bindings[0], result);
+	}
+
+
+private:
+
+	enum Operation
+	{
+		op_constant, op_binding, op_neg,
+		op_add, op_sub, op_mul, op_div, op_pow, op_log,
+		op_sin, op_cos, op_tan, op_asin, op_acos, op_atan,
+		op_ln, op_exp, op_sqrt, op_abs
+	};
+
+	struct Instruction
+	{
+		Operation op;
+		size_t index;	// of a constant or of a binding
+	};
+
+	typedef std::vector<Instruction> Program;
+
+	// arguments of a user-defined function which is being compiled
+	typedef std::vector<Program> Frame;
+
+	Program program;
+	std::vector<ValueType> constants;
+	std::vector<ValueType> stack;
+	size_t stack_size;
+	bool compiled;
+
+	// the unit of angles (from the settings) used by Evaluate()
+	int angle;
+
+	// used only during compiling
+	const char * pchar;
+	const std::vector<std::string> * parameters;
+	const EvaluatorSettings * settings;
+	const ttmath::Objects * variables;
+	const ttmath::Objects * functions;
+	ttmath::Conv conv;
+	std::vector<Frame> frames;
+	int depth;
+
+	// how deep variables and functions can be nested
+	static const int max_depth = 50;
+
+
+	void SkipWhite()
+	{
+		while( *pchar==' ' || *pchar=='\t' )
+			++pchar;
+	}
+
+
+	void Emit(Operation op, size_t index = 0)
+	{
+		Instruction ins;
+		ins.op    = op;
+		ins.index = index;
+
+		program.push_back(ins);
+	}
+
+
+	void EmitConstant(const ValueType & value)
+	{
+		constants.push_back(value);
+		Emit(op_constant, constants.size() - 1);
+	}
+
+
+	ttmath::ErrorCode Expression()
+	{
+	ttmath::ErrorCode code;
+
+		if( (code = Term()) != ttmath::err_ok )
+			return code;
+
+		while( true )
+		{
+			SkipWhite();
+
+			if( *pchar != '+' && *pchar != '-' )
+				break;
+
+			Operation op = (*pchar == '+') ? op_add : op_sub;
+			++pchar;
+
+			if( (code = Term()) != ttmath::err_ok )
+				return code;
+
+			Emit(op);
+		}
+
+	return ttmath::err_ok;
+	}
+
+
+	ttmath::ErrorCode Term()
+	{
+	ttmath::ErrorCode code;
+
+		if( (code = Unary()) != ttmath::err_ok )
+			return code;
+
+		while( true )
+		{
+			SkipWhite();
+
+			if( *pchar != '*' && *pchar != '/' )
+				break;
+
+			Operation op = (*pchar == '*') ? op_mul : op_div;
+			++pchar;
+
+			if( (code = Unary()) != ttmath::err_ok )
+				return code;
+
+			Emit(op);
+		}
+
+	return ttmath::err_ok;
+	}
+
+
+	ttmath::ErrorCode Unary()
+	{
+	ttmath::ErrorCode code;
+	bool power;
+
+		SkipWhite();
+
+		if( *pchar == '-' )
+		{
+			++pchar;
+
+			if( (code = Power(power)) != ttmath::err_ok )
+				return code;
+
+			// -a^b could be read as (-a)^b by the parser
+			if( power )
+				return ttmath::err_unknown_operator;
+
+			Emit(op_neg);
+
+		return ttmath::err_ok;
+		}
+
+	return Power(power);
+	}
+
+
+	ttmath::ErrorCode Power(bool & power)
+	{
+	ttmath::ErrorCode code;
+
+		power = false;
+
+		if( (code = Primary()) != ttmath::err_ok )
+			return code;
+
+		SkipWhite();
+
+		if( *pchar != '^' )
+			return ttmath::err_ok;
+
+		++pchar;
+		SkipWhite();
+
+		// a^-b
+		if( *pchar == '-' )
+			return ttmath::err_unknown_operator;
+
+		if( (code = Primary()) != ttmath::err_ok )
+			return code;
+
+		Emit(op_pow);
+		power = true;
+		SkipWhite();
+
+		// a^b^c
+		if( *pchar == '^' )
+			return ttmath::err_unknown_operator;
+
+	return ttmath::err_ok;
+	}
+
+
+	ttmath::ErrorCode Primary()
+	{
+	ttmath::ErrorCode code;
+
+		SkipWhite();
+
+		if( *pchar == '(' )
+		{
+			++pchar;
+
+			if( (code = Expression()) != ttmath::err_ok )
+				return code;
+
+			SkipWhite();
+
+			if( *pchar != ')' )
+				return ttmath::err_unexpected_end;
+
+			++pchar;
+
+		return ttmath::err_ok;
+		}
+
+		if( IsNameFirst(*pchar) )
+			return Name();
+
+	return Number();
+	}
+
+
+	ttmath::ErrorCode Number()
+	{
+	ValueType value;
+	const char * after;
+	bool value_read;
+
+		char c = *pchar;
+
+		if( !(c>='0' && c<='9') && (c==0 || (c != settings->input_comma1 && c != settings->input_comma2)) )
+			return ttmath::err_unknown_character;
+
+		if( value.FromString(pchar, conv, &after, &value_read) )
+			return ttmath::err_overflow;
+
+		if( !value_read )
+			return ttmath::err_unknown_character;
+
+		pchar = after;
+		EmitConstant(value);
+
+	return ttmath::err_ok;
+	}
+
+
+	static bool IsNameFirst(char c)
+	{
+		return (c>='a' && c<='z') || (c>='A' && c<='Z') || c=='_';
+	}
+
+
+	static bool IsNameChar(char c)
+	{
+		return IsNameFirst(c) || (c>='0' && c<='9');
+	}
+
+
+	ttmath::ErrorCode Name()
+	{
+	std::string name;
+
+		while( IsNameChar(*pchar) )
+			name += *pchar++;
+
+		SkipWhite();
+
+		if( *pchar == '(' )
+		{
+			++pchar;
+			return Call(name);
+		}
+
+	return Variable(name);
+	}
+
+
+	/*!
+		the index of a parameter of a user-defined function (x or x1..x9), or zero
+	*/
+	static size_t ArgumentIndex(const std::string & name)
+	{
+		if( name == "x" )
+			return 1;
+
+		if( name.size() == 2 && name[0] == 'x' && name[1] >= '1' && name[1] <= '9' )
+			return name[1] - '0';
+
+	return 0;
+	}
+
+
+	ttmath::ErrorCode Variable(const std::string & name)
+	{
+	const char * value;
+
+		// a parameter of the function which is being compiled
+		if( !frames.empty() )
+		{
+			size_t index = ArgumentIndex(name);
+			const Frame & frame = frames.back();
+
+			if( index > 0 && index <= frame.size() )
+			{
+				program.insert(program.end(), frame[index-1].begin(), frame[index-1].end());
+				return ttmath::err_ok;
+			}
+		}
+
+		for(size_t i=0 ; i<parameters->size() ; ++i)
+		{
+			if( (*parameters)[i] == name )
+			{
+				Emit(op_binding, i);
+				return ttmath::err_ok;
+			}
+		}
+
+		if( variables && variables->GetValue(name, &value) == ttmath::err_ok )
+		{
+			// the value is compiled without the parameters of the current function
+			frames.push_back(Frame());
+			ttmath::ErrorCode code = Inline(value, ttmath::err_variable_loop);
+			frames.pop_back();
+
+			return code;
+		}
+
+		ValueType constant;
+
+		if( name == "pi" )
+			constant.SetPi();
+		else
+		if( name == "e" )
+			constant.SetE();
+		else
+			return ttmath::err_unknown_variable;
+
+		EmitConstant(constant);
+
+	return ttmath::err_ok;
+	}
+
+
+	/*!
+		compiling a value of a variable or a body of a function in the current place
+	*/
+	ttmath::ErrorCode Inline(const char * str, ttmath::ErrorCode loop_error)
+	{
+		if( ++depth > max_depth )
+			return loop_error;
+
+		const char * old_pchar = pchar;
+		pchar = str;
+
+		ttmath::ErrorCode code = Expression();
+
+		if( code == ttmath::err_ok )
+		{
+			SkipWhite();
+
+			if( *pchar != 0 )
+				code = ttmath::err_unknown_character;
+		}
+
+		pchar = old_pchar;
+		--depth;
+
+	return code;
+	}
+
+
+	/*!
+		reading arguments of a function (the opening bracket has been read),
+		each argument is compiled into its own program
+	*/
+	ttmath::ErrorCode Arguments(Frame & args)
+	{
+	ttmath::ErrorCode code;
+
+		SkipWhite();
+
+		if( *pchar == ')' )
+		{
+			++pchar;
+			return ttmath::err_ok;
+		}
+
+		while( true )
+		{
+			size_t start = program.size();
+
+			if( (code = Expression()) != ttmath::err_ok )
+				return code;
+
+			args.push_back( Program(program.begin() + start, program.end()) );
+			program.resize(start);
+
+			SkipWhite();
+
+			if( *pchar == ')' )
+			{
+				++pchar;
+				break;
+			}
+
+			if( *pchar != settings->param_sep )
+				return ttmath::err_unexpected_end;
+
+			++pchar;
+		}
+
+	return ttmath::err_ok;
+	}
+
+
+	ttmath::ErrorCode Call(const std::string & name)
+	{
+	ttmath::ErrorCode code;
+	const char * body;
+	int param;
+	Frame args;
+
+		if( (code = Arguments(args)) != ttmath::err_ok )
+			return code;
+
+		if( functions && functions->GetValueAndParam(name, &body, &param) == ttmath::err_ok )
+		{
+			if( args.size() != size_t(param) )
+				return ttmath::err_improper_amount_of_arguments;
+
+			frames.push_back(args);
+			code = Inline(body, ttmath::err_functions_loop);
+			frames.pop_back();
+
+			return code;
+		}
+
+		Operation op;
+		size_t count = 1;
+
+		if( name == "sin" )		op = op_sin;	else
+		if( name == "cos" )		op = op_cos;	else
+		if( name == "tan" )		op = op_tan;	else
+		if( name == "asin" )	op = op_asin;	else
+		if( name == "acos" )	op = op_acos;	else
+		if( name == "atan" )	op = op_atan;	else
+		if( name == "ln" )		op = op_ln;		else
+		if( name == "exp" )		op = op_exp;	else
+		if( name == "sqrt" )	op = op_sqrt;	else
+		if( name == "abs" )		op = op_abs;	else
+		if( name == "log" )
+		{
+			op    = op_log;
+			count = 2;
+		}
+		else
+		{
+			return ttmath::err_unknown_function;
+		}
+
+		if( args.size() != count )
+			return ttmath::err_improper_amount_of_arguments;
+
+		for(size_t i=0 ; i<args.size() ; ++i)
+			program.insert(program.end(), args[i].begin(), args[i].end());
+
+		Emit(op);
+
+	return ttmath::err_ok;
+	}
+
+
+	/*!
+		the maximum depth of the stack when the program is running
+	*/
+	size_t StackSize() const
+	{
+	size_t sp = 0, max = 1;
+
+		for(size_t i=0 ; i<program.size() ; ++i)
+		{
+			switch( program[i].op )
+			{
+			case op_constant:
+			case op_binding:
+				if( ++sp > max )
+					max = sp;
+				break;
+
+			case op_add:
+			case op_sub:
+			case op_mul:
+			case op_div:
+			case op_pow:
+			case op_log:
+				--sp;
+				break;
+
+			default:
+				break;
+			}
+		}
+
+	return max;
+	}
+
+
+	/*!
+		angles are given in the unit from the settings (the same as the parser does)
+	*/
+	ttmath::ErrorCode ToRad(ValueType & x)
+	{
+	ttmath::ErrorCode err = ttmath::err_ok;
+
+		if( angle == 0 )
+			x = ttmath::DegToRad(x, &err);
+		else
+		if( angle == 2 )
+			x = ttmath::GradToRad(x, &err);
+
+	return err;
+	}
+
+
+	ttmath::ErrorCode FromRad(ValueType & x)
+	{
+	ttmath::ErrorCode err = ttmath::err_ok;
+
+		if( angle == 0 )
+			x = ttmath::RadToDeg(x, &err);
+		else
+		if( angle == 2 )
+			x = ttmath::RadToGrad(x, &err);
+
+	return err;
+	}
+
+
+	ttmath::ErrorCode Function(Operation op, ValueType & x)
+	{
+	ttmath::ErrorCode err = ttmath::err_ok;
+
+		switch( op )
+		{
+		case op_sin:
+			if( (err = ToRad(x)) == ttmath::err_ok )
+				x = ttmath::Sin(x, &err);
+			break;
+
+		case op_cos:
+			if( (err = ToRad(x)) == ttmath::err_ok )
+				x = ttmath::Cos(x, &err);
+			break;
+
+		case op_tan:
+			if( (err = ToRad(x)) == ttmath::err_ok )
+				x = ttmath::Tan(x, &err);
+			break;
+
+		case op_asin:
+			x = ttmath::ASin(x, &err);
+			if( err == ttmath::err_ok )
+				err = FromRad(x);
+			break;
+
+		case op_acos:
+			x = ttmath::ACos(x, &err);
+			if( err == ttmath::err_ok )
+				err = FromRad(x);
+			break;
+
+		case op_atan:
+			x = ttmath::ATan(x);
+			err = FromRad(x);
+			break;
+
+		case op_ln:
+			x = ttmath::Ln(x, &err);
+			break;
+
+		case op_exp:
+			x = ttmath::Exp(x, &err);
+			break;
+
+		case op_sqrt:
+			x = ttmath::Sqrt(x, &err);
+			break;
+
+		case op_abs:
+			x = ttmath::Abs(x);
+			break;
+
+		default:
+			err = ttmath::err_internal_error;
+			break;
+		}
+
+	return err;
+	}
+};
+
+
+#endif
@@ -0,0 +1,292 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "compileconfig.h"
+#include "configjournal.h"
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+
+ConfigJournal::ConfigJournal()
+{
+	records    = 0;
+	known_size = 0;
+}
+
+
+void ConfigJournal::SetFileName(const std::string & config_file)
+{
+	file_name  = config_file;
+	file_name += ".journal";
+	records    = 0;
+	known_size = FileSize();
+}
+
+
+const std::string & ConfigJournal::GetFileName() const
+{
+	return file_name;
+}
+
+
+bool ConfigJournal::SetVariable(const std::string & name, const std::string & value)
+{
+	if( !IsCorrectValue(value) )
+		return false;
+
+return Append("+v " + name + " = " + value);
+}
+
+
+bool ConfigJournal::DeleteVariable(const std::string & name)
+{
+	return Append("-v " + name);
+}
+
+
+bool ConfigJournal::SetFunction(const std::string & name, const std::string & value, int param)
+{
+	if( !IsCorrectValue(value) )
+		return false;
+
+	std::ostringstream record;
+	record << "+f " << name << " = " << param << " | " << value;
+
+return Append(record.str());
+}
+
+
+bool ConfigJournal::DeleteFunction(const std::string & name)
+{
+	return Append("-f " + name);
+}
+
+
+size_t ConfigJournal::Replay(IniParser::Section & variables, IniParser::Section & functions)
+{
+std::string line;
+
+	records = 0;
+	std::ifstream file(file_name.c_str(), std::ios_base::in | std::ios_base::binary);
+
+	if( !file )
+	{
+		known_size = 0;
+		return 0;
+	}
+
+	// a line without the new line character at the end of the file
+	// was not written to the end and it is skipped
+	while( std::getline(file, line) && !file.eof() )
+	{
+		ReadRecord(line, variables, functions);
+		++records;
+	}
+
+	known_size = FileSize();
+
+return records;
+}
+
+
+bool ConfigJournal::IsFull() const
+{
+	return records >= max_records;
+}
+
+
+void ConfigJournal::Clear()
+{
+	if( FileSize() == known_size )
+		remove(file_name.c_str());
+
+	records    = 0;
+	known_size = FileSize();
+}
+
+
+size_t ConfigJournal::Records() const
+{
+	return records;
+}
+
+
+/*!
+	one record is written at once and flushed to the disk
+	(other instances of the program can append to the same file)
+*/
+bool ConfigJournal::Append(const std::string & record)
+{
+	if( file_name.empty() )
+		return false;
+
+	std::ofstream file(file_name.c_str(), std::ios_base::out | std::ios_base::app | std::ios_base::binary);
+
+	if( !file )
+		return false;
+
+	std::string line(record);
+	line += '\n';
+
+	file.write(line.c_str(), line.size());
+	file.flush();
+
+	if( !file )
+		return false;
+
+	file.close();
+
+	if( !FlushFileToDisk(file_name) )
+		return false;
+
+	++records;
+	known_size = FileSize();
+
+return true;
+}
+
+
+/*!
+	-1 if there is no journal
+*/
+long ConfigJournal::FileSize() const
+{
+	std::ifstream file(file_name.c_str(), std::ios_base::in | std::ios_base::binary);
+
+	if( !file )
+		return -1;
+
+	file.seekg(0, std::ios_base::end);
+
+return long(file.tellg());
+}
+
+
+/*!
+	values are written in one line
+*/
+bool ConfigJournal::IsCorrectValue(const std::string & value)
+{
+	return value.find_first_of("\r\n") == std::string::npos;
+}
+
+
+void ConfigJournal::ReadRecord(const std::string & line, IniParser::Section & variables, IniParser::Section & functions)
+{
+	if( line.size() < 4 || line[2] != ' ' || (line[1] != 'v' && line[1] != 'f') )
+		return;
+
+	IniParser::Section & section = (line[1] == 'v') ? variables : functions;
+
+	if( line[0] == '-' )
+	{
+		section.erase(line.substr(3));
+	}
+	else
+	if( line[0] == '+' )
+	{
+		size_t eq = line.find(" = ", 3);
+
+		if( eq != std::string::npos )
+			section[line.substr(3, eq - 3)] = line.substr(eq + 3);
+	}
+}
+
+
+
+
+void WriteVariablesSection(std::ostream & out, const ttmath::Objects & variables)
+{
+	out << "[variables]\n";
+
+	for(ttmath::Objects::CIterator i = variables.Begin() ; i != variables.End() ; ++i)
+		out << i->first << " = " << i->second.value << '\n';
+}
+
+
+void WriteFunctionsSection(std::ostream & out, const ttmath::Objects & functions)
+{
+	out << "[functions]\n";
+
+	for(ttmath::Objects::CIterator i = functions.Begin() ; i != functions.End() ; ++i)
+		out << i->first << " = " << i->second.param << " | " << i->second.value << '\n';
+}
+
+
+bool FlushFileToDisk(const std::string & file_name)
+{
+#ifdef _WIN32
+	// FlushFileBuffers() needs the handle opened for writing
+	HANDLE file = CreateFileA(file_name.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+							  0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+
+	if( file == INVALID_HANDLE_VALUE )
+		return false;
+
+	bool flushed = FlushFileBuffers(file) != 0;
+	CloseHandle(file);
+#else
+	int file = open(file_name.c_str(), O_WRONLY);
+
+	if( file == -1 )
+		return false;
+
+	bool flushed = fsync(file) == 0;
+	close(file);
+#endif
+
+return flushed;
+}
+
+
+bool ReplaceFileAtomically(const std::string & temp, const std::string & target)
+{
+#ifdef _WIN32
+	return MoveFileExA(temp.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+	return rename(temp.c_str(), target.c_str()) == 0;
+#endif
+}
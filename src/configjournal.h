@@ -0,0 +1,177 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef headerfileconfigjournal
+#define headerfileconfigjournal
+
+/*!
+	\file configjournal.h
+    \brief a journal of changes of variables and functions (appended to a file)
+*/
+
+#include "compileconfig.h"
+#include "iniparser.h"
+#include <ttmath/ttmathobjects.h>
+#include <string>
+#include <ostream>
+
+
+/*!
+	\brief a journal of changes of variables and functions
+
+	the configuration file has all variables and functions and rewriting it
+	after each change takes a lot of time when there are many of them,
+	instead the change is appended as one line to the journal file (the name
+	of the configuration file with ".journal" added)
+
+		+v name = value
+		-v name
+		+f name = param | body
+		-f name
+
+	the journal is read after the configuration file and its changes are applied
+	in the same order, when there are too many of them (IsFull()) the whole
+	configuration file should be written again and then the journal is removed
+
+	each record is flushed to the disk before Append() returns,
+	if the program is killed while appending a line the line has no new line
+	character at the end and it is skipped when reading, the changes are
+	applied in such a way that applying them once more doesn't change anything,
+	so if the program is killed after the configuration file has been written
+	but before the journal has been removed nothing is lost either
+*/
+class ConfigJournal
+{
+public:
+
+	/*!
+		how many records can be in the journal before the configuration file
+		should be written again
+	*/
+	static const size_t max_records = 256;
+
+
+	ConfigJournal();
+
+
+	/*!
+		setting the name of the configuration file
+		(the journal is in the same directory)
+	*/
+	void SetFileName(const std::string & config_file);
+	const std::string & GetFileName() const;
+
+
+	/*!
+		appending a change, they return false if the change cannot be written
+		(then the whole configuration file should be written)
+	*/
+	bool SetVariable(const std::string & name, const std::string & value);
+	bool DeleteVariable(const std::string & name);
+	bool SetFunction(const std::string & name, const std::string & value, int param);
+	bool DeleteFunction(const std::string & name);
+
+
+	/*!
+		applying the changes from the journal to the sections read from
+		the configuration file (a function is kept as "param | body" there),
+		it returns how many records there were
+	*/
+	size_t Replay(IniParser::Section & variables, IniParser::Section & functions);
+
+
+	/*!
+		true if the configuration file should be written again
+	*/
+	bool IsFull() const;
+
+
+	/*!
+		removing the journal, call it after the configuration file has been written
+
+		if another instance of the program has appended something since we
+		have read or written the journal the file is left (its changes are
+		not in our configuration file)
+	*/
+	void Clear();
+
+
+	/*!
+		how many records there are in the journal
+	*/
+	size_t Records() const;
+
+
+private:
+
+	std::string file_name;
+	size_t records;
+
+	// the size of the journal after our last reading or writing
+	long known_size;
+
+	bool Append(const std::string & record);
+	long FileSize() const;
+	static bool IsCorrectValue(const std::string & value);
+	static void ReadRecord(const std::string & line, IniParser::Section & variables, IniParser::Section & functions);
+};
+
+
+
+/*!
+	writing the [variables] and [functions] sections of the configuration file
+*/
+void WriteVariablesSection(std::ostream & out, const ttmath::Objects & variables);
+void WriteFunctionsSection(std::ostream & out, const ttmath::Objects & functions);
+
+
+/*!
+	writing the data of a closed file from the cache of the system to the disk
+	(FlushFileBuffers() or fsync()), without it a file which is renamed just after
+	writing can be empty or partial after a power failure
+*/
+bool FlushFileToDisk(const std::string & file_name);
+
+
+/*!
+	replacing the 'target' file with the 'temp' file in one step
+	(if it fails the 'target' file is not changed)
+*/
+bool ReplaceFileAtomically(const std::string & temp, const std::string & target);
+
+
+#endif
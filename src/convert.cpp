@@ -36,6 +36,7 @@
  */
 
 #include "convert.h"
+#include <windows.h>
 
 
 
@@ -38,8 +38,8 @@
 #ifndef convertheader
 #define convertheader
 
-#include <windows.h>
 #include <string>
+#include <vector>
 #include "compileconfig.h"
 #include "bigtypes.h"
 
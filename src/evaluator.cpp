@@ -0,0 +1,532 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "compileconfig.h"
+#include "evaluator.h"
+#include <cstdio>
+#include <cstring>
+
+
+
+EvaluatorSettings::EvaluatorSettings()
+{
+	precision          = 0;
+	base_input         = 10;
+	base_output        = 10;
+	always_scientific  = false;
+	when_scientific    = 8;
+	rounding           = -1;
+	remove_zeroes      = true;
+	angle_deg_rad_grad = 1; // rad
+	fast_path          = false;
+
+	decimal_point      = '.';
+	grouping           = 0;
+	grouping_digits    = 3;
+	input_comma1       = '.';
+	input_comma2       = ',';
+	param_sep          = ';';
+
+	country            = Languages::en;
+
+	conv_type          = 0;
+	conv_input_unit    = -1;
+	conv_output_unit   = -1;
+}
+
+
+void EvaluatorSettings::SetConv(ttmath::Conv & conv) const
+{
+	conv.base         = base_output;
+	conv.scient       = always_scientific;
+	conv.scient_from  = when_scientific;
+	conv.round        = rounding;
+	conv.trim_zeroes  = remove_zeroes;
+	conv.comma        = decimal_point;
+	conv.group        = grouping;
+	conv.group_digits = grouping_digits;
+}
+
+
+bool EvaluatorSettings::CanWeConvert() const
+{
+	if( conv_type != 0 )
+		if( conv_input_unit!=-1 && conv_output_unit!=-1 &&
+			conv_input_unit!=conv_output_unit )
+			return true;
+
+return false;
+}
+
+
+
+
+bool EvaluatorSettings::SameParsing(const EvaluatorSettings & s) const
+{
+	return	precision          == s.precision          &&
+			base_input         == s.base_input         &&
+			angle_deg_rad_grad == s.angle_deg_rad_grad &&
+			input_comma1       == s.input_comma1       &&
+			input_comma2       == s.input_comma2       &&
+			grouping           == s.grouping           &&
+			param_sep          == s.param_sep;
+}
+
+
+bool EvaluatorSettings::Same(const EvaluatorSettings & s) const
+{
+	return	SameParsing(s)                         &&
+			base_output        == s.base_output        &&
+			always_scientific  == s.always_scientific  &&
+			when_scientific    == s.when_scientific    &&
+			rounding           == s.rounding           &&
+			remove_zeroes      == s.remove_zeroes      &&
+			fast_path          == s.fast_path          &&
+			decimal_point      == s.decimal_point      &&
+			grouping_digits    == s.grouping_digits    &&
+			country            == s.country            &&
+			conv_type          == s.conv_type          &&
+			conv_input_unit    == s.conv_input_unit    &&
+			conv_output_unit   == s.conv_output_unit;
+}
+
+
+
+
+Evaluator::Evaluator()
+{
+	for(int i=0 ; i<ttmath_levels ; ++i)
+	{
+		levels[i]      = 0;
+		levels_used[i] = 0;
+	}
+
+	idle_time    = 300;
+	fast_path_hits    = 0;
+	fast_path_inexact = false;
+	stop_object  = 0;
+	variables    = 0;
+	functions    = 0;
+	cache_size   = 64;
+	code         = ttmath::err_ok;
+	calculated   = false;
+	parsed       = false;
+	languages    = 0;
+	variables_id = 0;
+	functions_id = 0;
+
+	#ifdef TTCALC_CONVERT
+	convert   = 0;
+	#endif
+}
+
+
+Evaluator::~Evaluator()
+{
+	for(int i=0 ; i<ttmath_levels ; ++i)
+		delete levels[i];
+}
+
+
+/*!
+	the table of functions which create objects for the levels
+*/
+typedef EvaluatorLevelBase * (*EvaluatorLevelFactory)();
+
+#define TTCALC_LADDER_FACTORY(level, exponent_bits, mantissa_bits) \
+	&CreateEvaluatorLevel<level>,
+
+static const EvaluatorLevelFactory level_factory[] = {
+	TTCALC_PRECISION_LADDER(TTCALC_LADDER_FACTORY)
+};
+
+
+int Evaluator::Level(const EvaluatorSettings & s)
+{
+	if( s.precision < 0 )
+		return 0;
+
+	if( s.precision >= ttmath_levels )
+		return ttmath_levels - 1;
+
+return s.precision;
+}
+
+
+EvaluatorLevelBase * Evaluator::GetLevel(int level)
+{
+	if( !levels[level] )
+	{
+		EvaluatorLevelBase * plevel = level_factory[level]();
+
+		plevel->languages = languages;
+
+		#ifdef TTCALC_CONVERT
+		plevel->convert = convert;
+		#endif
+
+		plevel->SetStopObject(stop_object);
+		plevel->SetVariables(variables);
+		plevel->SetFunctions(functions);
+		plevel->SetCacheSize(cache_size);
+
+		levels[level] = plevel;
+	}
+
+return levels[level];
+}
+
+
+void Evaluator::SetStopObject(const volatile ttmath::StopCalculating * pstop_object)
+{
+	stop_object = pstop_object;
+
+	for(int i=0 ; i<ttmath_levels ; ++i)
+		if( levels[i] )
+			levels[i]->SetStopObject(stop_object);
+}
+
+
+void Evaluator::SetVariables(const ttmath::Objects * pvariables)
+{
+	variables = pvariables;
+
+	for(int i=0 ; i<ttmath_levels ; ++i)
+		if( levels[i] )
+			levels[i]->SetVariables(variables);
+}
+
+
+void Evaluator::SetFunctions(const ttmath::Objects * pfunctions)
+{
+	functions = pfunctions;
+
+	for(int i=0 ; i<ttmath_levels ; ++i)
+		if( levels[i] )
+			levels[i]->SetFunctions(functions);
+}
+
+
+void Evaluator::SetObjectsId(int pvariables_id, int pfunctions_id)
+{
+	variables_id = pvariables_id;
+	functions_id = pfunctions_id;
+}
+
+
+void Evaluator::SetCacheSize(size_t entries)
+{
+	cache_size = entries;
+
+	for(int i=0 ; i<ttmath_levels ; ++i)
+		if( levels[i] )
+			levels[i]->SetCacheSize(cache_size);
+}
+
+
+void Evaluator::ClearCache()
+{
+	for(int i=0 ; i<ttmath_levels ; ++i)
+		if( levels[i] )
+			levels[i]->ClearCache();
+}
+
+
+void Evaluator::SetIdleTime(unsigned int seconds)
+{
+	idle_time = seconds;
+}
+
+
+unsigned long Evaluator::FastPathHits() const
+{
+	return fast_path_hits;
+}
+
+
+size_t Evaluator::MemoryUsage(int level)
+{
+	if( level < 0 || level >= ttmath_levels || !levels[level] )
+		return 0;
+
+return levels[level]->MemoryUsage();
+}
+
+
+/*!
+	deleting levels which have not been used for 'idle_time' seconds
+	(the current one is used now, the values from the last parsing are there)
+*/
+void Evaluator::ReleaseIdleLevels(int current_level)
+{
+	time_t now = time(0);
+	levels_used[current_level] = now;
+
+	if( idle_time == 0 )
+		return;
+
+	for(int i=0 ; i<ttmath_levels ; ++i)
+	{
+		if( i != current_level && levels[i] && now - levels_used[i] >= (time_t)idle_time )
+		{
+			delete levels[i];
+			levels[i] = 0;
+		}
+	}
+}
+
+
+/*!
+	the key consists of settings which are used during parsing and of the input string
+	without white characters at the beginning and at the end
+	(settings of displaying are not here)
+
+	the key is empty if the cache is not used
+*/
+void Evaluator::MakeCacheKey(const char * str, const EvaluatorSettings & s)
+{
+char buf[100];
+
+	cache_key.clear();
+
+	if( cache_size == 0 )
+		return;
+
+	sprintf(buf, "%d %d %d %d %d %d %d %d|",
+		s.base_input, s.angle_deg_rad_grad,
+		(int)(unsigned char)s.input_comma1, (int)(unsigned char)s.input_comma2,
+		(int)(unsigned char)s.grouping, (int)(unsigned char)s.param_sep,
+		variables_id, functions_id);
+
+	cache_key = buf;
+
+	const char * end = str + strlen(str);
+
+	while( *str==' ' || *str=='\t' || *str=='\r' || *str=='\n' )
+		++str;
+
+	while( end > str && (end[-1]==' ' || end[-1]=='\t' || end[-1]=='\r' || end[-1]=='\n') )
+		--end;
+
+	cache_key.append(str, end);
+}
+
+
+void Evaluator::SetLanguages(Languages * planguages)
+{
+	languages = planguages;
+
+	for(int i=0 ; i<ttmath_levels ; ++i)
+		if( levels[i] )
+			levels[i]->languages = languages;
+}
+
+
+#ifdef TTCALC_CONVERT
+void Evaluator::SetConvert(Convert * pconvert)
+{
+	convert = pconvert;
+
+	for(int i=0 ; i<ttmath_levels ; ++i)
+		if( levels[i] )
+			levels[i]->convert = convert;
+}
+#endif
+
+
+ttmath::ErrorCode Evaluator::Parse(const char * str, const EvaluatorSettings & new_settings)
+{
+	settings = new_settings;
+
+	try
+	{
+		int level = Level(settings);
+		EvaluatorLevelBase * plevel = GetLevel(level);
+
+		ReleaseIdleLevels(level);
+		fast_path_inexact = false;
+		double value;
+
+		if( settings.fast_path && float_evaluator.Evaluate(str, settings, value) )
+		{
+			plevel->SetValue(value);
+			code              = ttmath::err_ok;
+			calculated        = true;
+			fast_path_inexact = !float_evaluator.Exact();
+			++fast_path_hits;
+		}
+		else
+		{
+			MakeCacheKey(str, settings);
+			code = plevel->Parse(str, settings, cache_key, calculated);
+		}
+	}
+	catch(...)
+	{
+		// we can be in a thread, we shouldn't go up
+		code = ttmath::err_internal_error;
+	}
+
+	parsed = true;
+
+return code;
+}
+
+
+bool Evaluator::IsCached(const char * str, const EvaluatorSettings & s)
+{
+	EvaluatorLevelBase * plevel = levels[Level(s)];
+
+	if( !plevel || cache_size == 0 )
+		return false;
+
+	MakeCacheKey(str, s);
+
+return plevel->IsCached(cache_key);
+}
+
+
+bool Evaluator::CanReprint(const EvaluatorSettings & new_settings) const
+{
+	if( !parsed || code == ttmath::err_interrupt || code == ttmath::err_internal_error )
+		return false;
+
+	// the digits are proven only for the settings of displaying used during parsing
+	if( fast_path_inexact )
+		return false;
+
+return settings.SameParsing(new_settings);
+}
+
+
+bool Evaluator::Reprint(const EvaluatorSettings & new_settings)
+{
+	if( !CanReprint(new_settings) )
+		return false;
+
+	settings = new_settings;
+
+return true;
+}
+
+
+ttmath::ErrorCode Evaluator::GetLastCode() const
+{
+	return code;
+}
+
+
+const EvaluatorSettings & Evaluator::GetSettings() const
+{
+	return settings;
+}
+
+
+bool Evaluator::Calculated()
+{
+	return calculated;
+}
+
+
+size_t Evaluator::ResultSize()
+{
+	if( !parsed )
+		return 0;
+
+return GetLevel(Level(settings))->ResultSize();
+}
+
+
+int Evaluator::PrintValue(size_t index, std::string & result)
+{
+	result.clear();
+
+	if( index >= ResultSize() )
+		return 0;
+
+return levels[Level(settings)]->PrintValue(index, settings, result);
+}
+
+
+int Evaluator::PrintValueForInput(size_t index, std::string & result)
+{
+EvaluatorSettings input(settings);
+
+	result.clear();
+
+	if( index >= ResultSize() )
+		return 0;
+
+	input.base_output       = settings.base_input;
+	input.always_scientific = false;
+	input.when_scientific   = 4096;
+	input.rounding          = -1;
+	input.remove_zeroes     = true;
+	input.decimal_point     = settings.input_comma1;
+	input.grouping          = 0;
+	input.conv_type         = 0;
+
+	int carry = levels[Level(settings)]->PrintValue(index, input, result);
+
+	// a value beginning with a letter would be taken as a name
+	if( settings.base_input > 10 && !result.empty() )
+		result.insert(result[0] == '-' ? 1 : 0, 1, '0');
+
+return carry;
+}
+
+
+int Evaluator::PrintResult(std::string & result, const char * separator)
+{
+size_t i, len = ResultSize();
+
+	result.clear();
+
+	for(i=0 ; i<len ; ++i)
+	{
+		if( PrintValue(i, buffer) )
+			return 1;
+
+		result += buffer;
+
+		if( i < len-1 )
+			result += separator;
+	}
+
+return 0;
+}
+
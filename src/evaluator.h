@@ -0,0 +1,588 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef headerfileevaluator
+#define headerfileevaluator
+
+/*!
+	\file evaluator.h
+    \brief the evaluation core (parsing and printing) which doesn't use the win32 api
+*/
+
+#include "compileconfig.h"
+#include "bigtypes.h"
+#include "languages.h"
+#include "resultcache.h"
+#include "floatevaluator.h"
+
+#ifdef TTCALC_CONVERT
+#include "convert.h"
+#endif
+
+#include <ttmath/ttmathobjects.h>
+#include <string>
+#include <vector>
+#include <ctime>
+
+
+/*!
+	\brief a snapshot of settings which are used during parsing and printing
+
+	the gui thread copies them from ProgramResources (GetEvaluatorSettings())
+	and other front ends (e.g. the batch evaluator) set them directly,
+	the default values are the same as the defaults in ProgramResources
+*/
+struct EvaluatorSettings
+{
+	int  precision;			// a level of the precision ladder (bigtypes.h)
+	int  base_input;
+	int  base_output;
+	bool always_scientific;
+	int  when_scientific;
+	int  rounding;
+	bool remove_zeroes;
+	int  angle_deg_rad_grad;
+
+	// simple arithmetic is calculated on doubles if the result can be proven (FloatEvaluator)
+	bool fast_path;
+
+	char decimal_point;
+	char grouping;
+	int  grouping_digits;
+	char input_comma1;
+	char input_comma2;
+	char param_sep;
+
+	Languages::Country country;
+
+	// used only with TTCALC_CONVERT
+	int conv_type;
+	int conv_input_unit;
+	int conv_output_unit;
+
+
+	EvaluatorSettings();
+
+
+	/*!
+		it sets the ttmath::Conv structure used when printing values
+	*/
+	void SetConv(ttmath::Conv & conv) const;
+
+
+	/*!
+		returning true if the unit conversion should be made
+	*/
+	bool CanWeConvert() const;
+
+
+	/*!
+		returning true if settings used during parsing are the same
+		(the rest of settings is used only for displaying)
+	*/
+	bool SameParsing(const EvaluatorSettings & s) const;
+
+
+	/*!
+		returning true if all settings are the same
+		(results calculated with the other settings can be used)
+	*/
+	bool Same(const EvaluatorSettings & s) const;
+};
+
+
+
+/*!
+	\brief parsing and printing with one level of the precision ladder
+
+	the evaluator has one object of this kind for each level which has been used,
+	the objects are created by CreateEvaluatorLevel<level>()
+*/
+class EvaluatorLevelBase
+{
+public:
+
+	EvaluatorLevelBase()
+	{
+		languages = 0;
+
+		#ifdef TTCALC_CONVERT
+		convert   = 0;
+		#endif
+	}
+
+
+	virtual ~EvaluatorLevelBase()
+	{
+	}
+
+
+	virtual void SetStopObject(const volatile ttmath::StopCalculating * stop_object) = 0;
+	virtual void SetVariables(const ttmath::Objects * pvariables) = 0;
+	virtual void SetFunctions(const ttmath::Objects * pfunctions) = 0;
+
+	virtual void SetCacheSize(size_t entries) = 0;
+	virtual void ClearCache() = 0;
+	virtual bool IsCached(const std::string & key) = 0;
+
+
+	/*!
+		parsing the string, the values are taken from the cache if there is the key
+		('key' is empty if the cache is not used)
+	*/
+	virtual ttmath::ErrorCode Parse(const char * str, const EvaluatorSettings & settings,
+									const std::string & key, bool & calculated) = 0;
+
+	virtual size_t ResultSize() = 0;
+
+
+	/*!
+		setting one value as the result (from the fast path), the cache is not used
+	*/
+	virtual void SetValue(double value) = 0;
+
+
+	/*!
+		an estimate of memory used by this object (in bytes)
+	*/
+	virtual size_t MemoryUsage() = 0;
+
+
+	/*!
+		printing one value from the last parsing
+		returning 1 if there was a carry during converting
+	*/
+	virtual int PrintValue(size_t index, const EvaluatorSettings & settings, std::string & result) = 0;
+
+
+	Languages * languages;
+
+	#ifdef TTCALC_CONVERT
+	Convert * convert;
+	#endif
+};
+
+
+
+template<class ValueType>
+class EvaluatorLevel : public EvaluatorLevelBase
+{
+public:
+
+	void SetStopObject(const volatile ttmath::StopCalculating * stop_object)
+	{
+		parser.SetStopObject(stop_object);
+	}
+
+
+	void SetVariables(const ttmath::Objects * pvariables)
+	{
+		parser.SetVariables(pvariables);
+	}
+
+
+	void SetFunctions(const ttmath::Objects * pfunctions)
+	{
+		parser.SetFunctions(pfunctions);
+	}
+
+
+	void SetCacheSize(size_t entries)
+	{
+		cache.SetMaxSize(entries);
+	}
+
+
+	void ClearCache()
+	{
+		cache.Clear();
+	}
+
+
+	bool IsCached(const std::string & key)
+	{
+		return cache.GetMaxSize() > 0 && cache.Find(key) != 0;
+	}
+
+
+	ttmath::ErrorCode Parse(const char * str, const EvaluatorSettings & settings,
+							const std::string & key, bool & calculated)
+	{
+	ttmath::ErrorCode code;
+
+		if( !key.empty() )
+		{
+			const typename ResultCache<ValueType>::Entry * entry = cache.Find(key);
+
+			if( entry )
+			{
+				values     = entry->values;
+				calculated = entry->calculated;
+				return ttmath::err_ok;
+			}
+		}
+
+		parser.SetBase(settings.base_input);
+		parser.SetDegRadGrad(settings.angle_deg_rad_grad);
+		parser.SetComma(settings.input_comma1, settings.input_comma2);
+		parser.SetGroup(settings.grouping);
+		parser.SetParamSep(settings.param_sep);
+
+		code       = parser.Parse(str);
+		calculated = parser.Calculated();
+
+		values.resize(parser.stack.size());
+
+		for(size_t i=0 ; i<values.size() ; ++i)
+			values[i] = parser.stack[i].value;
+
+		// errors are not cached (e.g. the calculations could have been interrupted)
+		if( code == ttmath::err_ok && !key.empty() )
+			cache.Insert(key, values, calculated);
+
+	return code;
+	}
+
+
+	size_t ResultSize()
+	{
+		return values.size();
+	}
+
+
+	void SetValue(double value)
+	{
+		values.resize(1);
+		values[0] = value;
+	}
+
+
+	/*!
+		the object itself, the stack of the parser, the values and the cache
+		(tables of functions and operators in the parser are not counted)
+	*/
+	size_t MemoryUsage()
+	{
+	size_t size = sizeof(*this);
+
+		size += parser.stack.capacity() * sizeof(typename ttmath::Parser<ValueType>::Item);
+		size += values.capacity() * sizeof(ValueType);
+		size += cache.MemoryUsage();
+
+	return size;
+	}
+
+
+	// 1 if carry
+	int PrintValue(size_t index, const EvaluatorSettings & settings, std::string & result)
+	{
+		try
+		{
+			ValueType value = values[index];
+
+			#ifdef TTCALC_CONVERT
+			if( convert && settings.CanWeConvert() )
+			{
+				if( convert->Conversion(settings.conv_input_unit, settings.conv_output_unit, value) )
+					return 1;
+			}
+			#endif
+
+			ttmath::Conv conv;
+			settings.SetConv(conv);
+
+			if( value.ToString(result, conv) )
+			{
+				// we shouldn't have had this error in the new version of ToStrign(...)
+				// (where we're using a bigger type for calculating)
+				result = languages->GuiMessage(settings.country, Languages::overflow_during_printing);
+			}
+		}
+		catch(...)
+		{
+			result = languages->ErrorMessage(settings.country, ttmath::err_internal_error);
+		}
+
+	return 0;
+	}
+
+
+private:
+
+	ttmath::Parser<ValueType> parser;
+	ResultCache<ValueType> cache;
+	std::vector<ValueType> values;
+};
+
+
+
+/*!
+	creating the object for the given level of the precision ladder
+*/
+template<int level>
+EvaluatorLevelBase * CreateEvaluatorLevel()
+{
+	return new EvaluatorLevel<typename TTMathLevel<level>::Type>();
+}
+
+
+
+/*!
+	\brief the evaluation core
+
+	it maintains the parsers for all levels of the precision ladder (a parser is created
+	when its level is used for the first time),
+	parses a string with given settings and prints the result into a std::string,
+	there are no references to windows or to GetPrgRes() here so this object can be
+	used by the second thread (through ParserManager), by the pad and by the
+	command line front ends
+
+	before parsing you should set the languages object (it is used for printing errors)
+	and the tables with variables and functions, the stop object is optional
+
+	values from the parser's stack are copied after parsing and they are kept
+	in a bounded LRU cache (one for each level), if the same string is parsed
+	again with the same settings of parsing then the values are taken from the cache
+	and only printing is made
+*/
+class Evaluator
+{
+public:
+
+	Evaluator();
+	~Evaluator();
+
+
+	/*!
+		setting the object which is checked during long calculations
+	*/
+	void SetStopObject(const volatile ttmath::StopCalculating * stop_object);
+
+
+	/*!
+		setting the user-defined variables and functions
+		(the objects are not copied, they must exist when Parse() is called)
+	*/
+	void SetVariables(const ttmath::Objects * pvariables);
+	void SetFunctions(const ttmath::Objects * pfunctions);
+
+
+	/*!
+		identifiers of the current state of variables and functions (they are a part
+		of the key in the cache), if you change the tables you should change the ids too
+		(or call ClearCache())
+	*/
+	void SetObjectsId(int pvariables_id, int pfunctions_id);
+
+
+	/*!
+		the maximum number of entries in the cache of each precision (zero turns it off)
+	*/
+	void SetCacheSize(size_t entries);
+
+
+	/*!
+		removing all results from the caches
+	*/
+	void ClearCache();
+
+
+	/*!
+		a level which has not been used for 'seconds' is released (its parser and its cache
+		are deleted) when another level is parsed, zero means the levels are never released
+		(default: 300 seconds)
+	*/
+	void SetIdleTime(unsigned int seconds);
+
+
+	/*!
+		how many times the result has been taken from the fast path
+		(EvaluatorSettings::fast_path)
+	*/
+	unsigned long FastPathHits() const;
+
+
+	/*!
+		an estimate of memory used by the given level of the precision ladder (in bytes),
+		zero if the level has not been created yet (or has been released)
+	*/
+	size_t MemoryUsage(int level);
+
+
+	/*!
+		setting the languages' object used when printing error messages
+	*/
+	void SetLanguages(Languages * planguages);
+
+
+	#ifdef TTCALC_CONVERT
+	/*!
+		setting the object for converting units
+	*/
+	void SetConvert(Convert * pconvert);
+	#endif
+
+
+	/*!
+		parsing the string with the parser selected by settings.precision
+		(the settings are remembered and used later when printing)
+	*/
+	ttmath::ErrorCode Parse(const char * str, const EvaluatorSettings & new_settings);
+
+
+	/*!
+		it's used when only settings of displaying have changed: values from the last
+		parsing are kept and they will be printed with the new settings
+
+		it returns false if the values cannot be used (nothing was parsed, the last
+		parsing was interrupted or settings of parsing are different) - you should
+		call Parse() then, the caller is responsible for the input string and
+		the variables and functions being the same as during the last parsing
+	*/
+	bool Reprint(const EvaluatorSettings & new_settings);
+
+
+	/*!
+		the same test as in Reprint() but the settings are not changed
+	*/
+	bool CanReprint(const EvaluatorSettings & new_settings) const;
+
+
+	/*!
+		returning true if the result of the string parsed with the given settings
+		is in the cache (Parse() would not calculate anything then)
+	*/
+	bool IsCached(const char * str, const EvaluatorSettings & s);
+
+
+	/*!
+		the code from the last parsing
+	*/
+	ttmath::ErrorCode GetLastCode() const;
+
+
+	/*!
+		returning the settings used by the last parsing
+	*/
+	const EvaluatorSettings & GetSettings() const;
+
+
+	/*!
+		true if the last parsing has calculated something
+		(e.g. it is false if there was only an assignment)
+	*/
+	bool Calculated();
+
+
+	/*!
+		how many values are on the stack after the last parsing
+		(values are separated by semicolons in the input string)
+	*/
+	size_t ResultSize();
+
+
+	/*!
+		printing one value from the stack (the unit conversion is made if set)
+		returning 1 if there was a carry during converting
+	*/
+	int PrintValue(size_t index, std::string & result);
+
+
+	/*!
+		printing all values from the stack separated by 'separator'
+		returning 1 if there was a carry during converting
+	*/
+	int PrintResult(std::string & result, const char * separator);
+
+
+	/*!
+		printing one value in such a form that the parser can read it again
+		(all digits in the input base, no grouping and no scientific mode),
+		it is used when a result is given to the parser as a value of a variable
+	*/
+	int PrintValueForInput(size_t index, std::string & result);
+
+
+private:
+
+	// objects for the levels of the precision ladder (null if a level has not been used yet)
+	EvaluatorLevelBase * levels[ttmath_levels];
+
+	// when the levels were used last time
+	time_t levels_used[ttmath_levels];
+	unsigned int idle_time;
+
+	const volatile ttmath::StopCalculating * stop_object;
+	const ttmath::Objects * variables;
+	const ttmath::Objects * functions;
+	size_t cache_size;
+
+	EvaluatorSettings settings;
+	ttmath::ErrorCode code;
+	bool calculated;
+	bool parsed;
+	Languages * languages;
+
+	int variables_id;
+	int functions_id;
+	std::string cache_key;
+
+	FloatEvaluator float_evaluator;
+	unsigned long fast_path_hits;
+
+	// the last result is from the fast path and it's valid only with the rounding used
+	bool fast_path_inexact;
+
+	#ifdef TTCALC_CONVERT
+	Convert * convert;
+	#endif
+
+	std::string buffer;
+
+
+	Evaluator(const Evaluator &);
+	Evaluator & operator=(const Evaluator &);
+
+	static int Level(const EvaluatorSettings & s);
+	EvaluatorLevelBase * GetLevel(int level);
+	void ReleaseIdleLevels(int current_level);
+	void MakeCacheKey(const char * str, const EvaluatorSettings & s);
+
+};
+
+
+#endif
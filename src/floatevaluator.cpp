@@ -0,0 +1,437 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "compileconfig.h"
+#include "floatevaluator.h"
+#include "evaluator.h"
+#include <cmath>
+#include <cfloat>
+
+
+
+namespace
+{
+
+// the unit roundoff of double (2^-53)
+const double unit = DBL_EPSILON / 2.0;
+
+// integers smaller than this are exact
+const double max_exact = 9007199254740992.0;
+
+// powers of ten which are exact in double
+const double power10[] = {
+	1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+const int power10_max = sizeof(power10) / sizeof(double) - 1;
+
+
+/*!
+	a bound of an error is made a little bigger to cover the rounding
+	during calculating the bound itself
+*/
+double Grow(double error)
+{
+	return error * (1.0 + 8.0 * unit) + DBL_MIN;
+}
+
+
+bool IsDigit(char c)
+{
+	return c>='0' && c<='9';
+}
+
+} // namespace
+
+
+
+FloatEvaluator::FloatEvaluator()
+{
+	pchar    = 0;
+	settings = 0;
+	exact    = false;
+}
+
+
+bool FloatEvaluator::Exact() const
+{
+	return exact;
+}
+
+
+bool FloatEvaluator::Evaluate(const char * str, const EvaluatorSettings & psettings, double & result)
+{
+Value value;
+
+	exact    = false;
+	pchar    = str;
+	settings = &psettings;
+
+	if( settings->base_input != 10 )
+		return false;
+
+	if( !Expression(value) )
+		return false;
+
+	SkipWhite();
+
+	if( *pchar != 0 || !Proven(value) )
+		return false;
+
+	result = value.value;
+	exact  = value.exact;
+
+return true;
+}
+
+
+void FloatEvaluator::SkipWhite()
+{
+	while( *pchar==' ' || *pchar=='\t' || *pchar=='\r' || *pchar=='\n' )
+		++pchar;
+}
+
+
+bool FloatEvaluator::Expression(Value & result)
+{
+Value second;
+
+	if( !Term(result) )
+		return false;
+
+	while( true )
+	{
+		SkipWhite();
+
+		if( *pchar != '+' && *pchar != '-' )
+			break;
+
+		bool minus = (*pchar == '-');
+		++pchar;
+
+		if( !Term(second) )
+			return false;
+
+		if( minus )
+			second.value = -second.value;
+
+		Add(result, second, result);
+
+		if( !Check(result) )
+			return false;
+	}
+
+return true;
+}
+
+
+bool FloatEvaluator::Term(Value & result)
+{
+Value second;
+
+	if( !Factor(result) )
+		return false;
+
+	while( true )
+	{
+		SkipWhite();
+
+		if( *pchar != '*' && *pchar != '/' )
+			break;
+
+		bool div = (*pchar == '/');
+		++pchar;
+
+		if( !Factor(second) )
+			return false;
+
+		if( div )
+		{
+			if( !Div(result, second, result) )
+				return false;
+		}
+		else
+		{
+			Mul(result, second, result);
+		}
+
+		if( !Check(result) )
+			return false;
+	}
+
+return true;
+}
+
+
+bool FloatEvaluator::Factor(Value & result)
+{
+	SkipWhite();
+
+	if( *pchar == '-' )
+	{
+		++pchar;
+
+		if( !Factor(result) )
+			return false;
+
+		result.value = -result.value;
+
+		if( result.value == 0.0 )
+			result.value = 0.0; // without the sign
+
+	return true;
+	}
+
+	if( *pchar == '(' )
+	{
+		++pchar;
+
+		if( !Expression(result) )
+			return false;
+
+		SkipWhite();
+
+		if( *pchar != ')' )
+			return false;
+
+		++pchar;
+
+	return true;
+	}
+
+return Number(result);
+}
+
+
+/*!
+	reading a number: digits with an optional decimal point followed by digits
+
+	the digits are read into an integer (at most 15 digits so it's exact) and
+	divided by a power of ten (exact too) so the value is rounded only once
+*/
+bool FloatEvaluator::Number(Value & result)
+{
+double mantissa = 0.0;
+int digits = 0, scale = 0;
+
+	if( !IsDigit(*pchar) )
+		return false;
+
+	for( ; IsDigit(*pchar) ; ++pchar )
+	{
+		mantissa = mantissa * 10.0 + (*pchar - '0');
+
+		if( mantissa != 0.0 && ++digits > 15 )
+			return false;
+	}
+
+	char c = *pchar;
+
+	if( c != 0 && c != settings->grouping &&
+		(c == settings->input_comma1 || c == settings->input_comma2) )
+	{
+		++pchar;
+
+		if( !IsDigit(*pchar) )
+			return false;
+
+		for( ; IsDigit(*pchar) ; ++pchar, ++scale )
+		{
+			mantissa = mantissa * 10.0 + (*pchar - '0');
+
+			if( (mantissa != 0.0 && ++digits > 15) || scale >= power10_max )
+				return false;
+		}
+	}
+
+	if( scale == 0 )
+	{
+		result.value = mantissa;
+		result.error = 0.0;
+		result.exact = true;
+	}
+	else
+	{
+		result.value = mantissa / power10[scale];
+		result.error = Grow(unit * fabs(result.value));
+		result.exact = false;
+	}
+
+return Check(result);
+}
+
+
+/*!
+	the value and the error should be finite and far from underflow
+	(the error of rounding would not be relative then)
+*/
+bool FloatEvaluator::Check(Value & result)
+{
+	double abs_value = fabs(result.value);
+
+	if( !(abs_value <= DBL_MAX) || !(result.error <= DBL_MAX) )
+		return false;
+
+	if( result.value != 0.0 && abs_value < 1e-290 )
+		return false;
+
+return true;
+}
+
+
+bool FloatEvaluator::IsInteger(double x)
+{
+	return x == floor(x);
+}
+
+
+void FloatEvaluator::Add(const Value & a, const Value & b, Value & result)
+{
+	double value = a.value + b.value;
+
+	if( value == 0.0 )
+		value = 0.0;
+
+	if( a.exact && b.exact && fabs(value) < max_exact )
+	{
+		// a sum of integers smaller than 2^53 is exact
+		result.error = 0.0;
+		result.exact = true;
+	}
+	else
+	{
+		result.error = Grow(a.error + b.error + unit * fabs(value));
+		result.exact = false;
+	}
+
+	result.value = value;
+}
+
+
+void FloatEvaluator::Mul(const Value & a, const Value & b, Value & result)
+{
+	double value = a.value * b.value;
+
+	if( value == 0.0 )
+		value = 0.0;
+
+	if( a.exact && b.exact && fabs(value) < max_exact )
+	{
+		result.error = 0.0;
+		result.exact = true;
+	}
+	else
+	{
+		result.error = Grow(fabs(a.value) * b.error + fabs(b.value) * a.error +
+							a.error * b.error + unit * fabs(value));
+		result.exact = false;
+	}
+
+	result.value = value;
+}
+
+
+/*!
+	false if the divisor can be zero
+*/
+bool FloatEvaluator::Div(const Value & a, const Value & b, Value & result)
+{
+	double abs_b = fabs(b.value);
+
+	if( abs_b == 0.0 || abs_b <= b.error )
+		return false;
+
+	double value = a.value / b.value;
+
+	if( value == 0.0 )
+		value = 0.0;
+
+	if( a.exact && b.exact && IsInteger(value) && fabs(value) < max_exact && value * b.value == a.value )
+	{
+		result.error = 0.0;
+		result.exact = true;
+	}
+	else
+	{
+		result.error = Grow( (fabs(a.value) * b.error + abs_b * a.error) / (abs_b * (abs_b - b.error)) +
+							  unit * fabs(value) );
+		result.exact = false;
+	}
+
+	result.value = value;
+
+return true;
+}
+
+
+/*!
+	true if the printed value would be the same as the value calculated by ttmath
+*/
+bool FloatEvaluator::Proven(const Value & result)
+{
+	if( result.exact )
+		return true;
+
+	const EvaluatorSettings & s = *settings;
+
+	if( s.rounding < 0 || s.rounding > 15 || s.base_output != 10 ||
+		s.always_scientific || s.CanWeConvert() || s.when_scientific > power10_max )
+		return false;
+
+	// the interval with the true value (and with the value from ttmath which has its own
+	// small error), a bit bigger to cover the rounding in the calculations below
+	double abs_value = fabs(result.value);
+	double margin    = Grow(result.error + 4.0 * unit * abs_value);
+	double low       = abs_value - margin;
+	double high      = abs_value + margin;
+
+	// far from the scientific mode (the rounding is used for digits after the comma)
+	int ws = s.when_scientific;
+
+	if( ws < 1 || low <= 1.0 / power10[ws-1] || high >= power10[ws-1] )
+		return false;
+
+	low  *= power10[s.rounding];
+	high *= power10[s.rounding];
+
+	// the digits would not be valid
+	if( high >= max_exact / 8.0 )
+		return false;
+
+return floor(low + 0.5) == floor(high + 0.5);
+}
@@ -0,0 +1,120 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef headerfilefloatevaluator
+#define headerfilefloatevaluator
+
+/*!
+	\file floatevaluator.h
+    \brief the fast path: simple arithmetic calculated on the hardware floating point
+*/
+
+#include "compileconfig.h"
+
+
+struct EvaluatorSettings;
+
+
+/*!
+	\brief simple arithmetic calculated on doubles with a bound of the error
+
+	only numbers in the decimal system, the four basic operators, unary minus
+	and brackets are recognized, everything else (variables, functions, other
+	operators, other bases, more than one expression) makes Evaluate() return false
+	and the expression has to be calculated by ttmath
+
+	each value has a bound of its absolute error: numbers which are not integers
+	are rounded when read, and each operation adds the rounding of its result and
+	propagates the errors of its arguments; integers smaller than 2^53 are exact
+	as long as the results are integers smaller than 2^53 too
+
+	Evaluate() returns true only when the bound proves that the printed result is
+	the same as the result from ttmath would be: either the value is exact or it is
+	printed in the decimal system with rounding (EvaluatorSettings::rounding) and
+	there is no rounding boundary in the interval [value - error, value + error]
+*/
+class FloatEvaluator
+{
+public:
+
+	FloatEvaluator();
+
+
+	/*!
+		calculating the string, true if the result can be used
+		(the value is then in 'result')
+	*/
+	bool Evaluate(const char * str, const EvaluatorSettings & settings, double & result);
+
+
+	/*!
+		true if the last result from Evaluate() was exact
+		(an inexact value is proven only for the rounding of the settings)
+	*/
+	bool Exact() const;
+
+
+private:
+
+	struct Value
+	{
+		double value;
+		double error;	// a bound of the absolute error
+		bool exact;
+	};
+
+	const char * pchar;
+	const EvaluatorSettings * settings;
+	bool exact;
+
+	bool Expression(Value & result);
+	bool Term(Value & result);
+	bool Factor(Value & result);
+	bool Number(Value & result);
+
+	void SkipWhite();
+	bool Check(Value & result);
+	bool Proven(const Value & result);
+
+	static bool IsInteger(double x);
+	static void Add(const Value & a, const Value & b, Value & result);
+	static void Mul(const Value & a, const Value & b, Value & result);
+	static bool Div(const Value & a, const Value & b, Value & result);
+};
+
+
+#endif
@@ -158,55 +158,59 @@ const char * message;
 
 
 
-int AddNewItemToFunctionList(HWND list, const std::string & name,
-							  const std::string & value, int parameters)
-{
-LVITEM item;
-char buffer[20];
-
-	item.mask     = LVIF_TEXT;
-	item.pszText  = const_cast<char*>( name.c_str() );
-	item.iSubItem = 0;
-
-	int id = ListView_InsertItem(list, &item);
-
-	sprintf(buffer,"%u", parameters);
-	ListView_SetItemText(list,id,1, buffer);
+/*!
+	the rows of the virtual list of functions
+*/
+ObjectsList rows;
 
-	ListView_SetItemText(list,id,2,const_cast<char*>( value.c_str() ));
 
-return id;
+/*!
+	taking the current functions into the list
+*/
+void FillUpList(HWND list, const std::string & select)
+{
+	rows.SetObjects( GetPrgRes()->GetFunctionsSnapshot() );
+	Variables::ShowRows(list, rows, select);
 }
 
 
+/*!
+	giving the text of a row to the list (LVN_GETDISPINFO)
+*/
+void GetDispInfo(NMLVDISPINFO * info)
+{
+	if( (info->item.mask & LVIF_TEXT) == 0 || info->item.iItem < 0 || size_t(info->item.iItem) >= rows.Size() )
+		return;
 
+	ObjectsList::CIterator i = rows.Row(info->item.iItem);
+	char buffer[20];
 
-
-void ChangeItemInFunctionList(	HWND list, int id, const std::string & old_name,
-								const std::string & new_name, const std::string & value,
-								int parameters)
-{
-	if( old_name != new_name )
+	if( info->item.iSubItem == 0 )
+	{
+		lstrcpyn(info->item.pszText, i->first.c_str(), info->item.cchTextMax);
+	}
+	else
+	if( info->item.iSubItem == 1 )
 	{
-		ListView_DeleteItem(list, id);
-		// as we're using ListView_DeleteItem here the WM_NOTIFY is generated
-		// and system will call SetDisablingEditDeleteFunctionButtons
-		// and eventually the focus will be changed into the 'add' button
-		// (it's a small inconvenience)
-
-		int new_id = AddNewItemToFunctionList(list, new_name, value, parameters);
-		ListView_SetItemState(list,new_id, LVIS_FOCUSED|LVIS_SELECTED,LVIS_FOCUSED|LVIS_SELECTED);
+		sprintf(buffer,"%u", i->second.param);
+		lstrcpyn(info->item.pszText, buffer, info->item.cchTextMax);
 	}
 	else
 	{
-		char buffer[20];
-		sprintf(buffer,"%u", parameters);
-		ListView_SetItemText(list,id,1, buffer);
-		ListView_SetItemText(list,id,2,const_cast<char*>( value.c_str() ));
+		lstrcpyn(info->item.pszText, i->second.value.c_str(), info->item.cchTextMax);
 	}
 }
 
 
+BOOL WmTabCommand_FilterChanged(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+	if( HIWORD(wParam) == EN_CHANGE )
+		Variables::FilterRows(GetDlgItem(hWnd, IDC_FUNCTIONS_LIST), GetDlgItem(hWnd, IDC_EDIT_FUNCTIONS_FILTER), rows);
+
+return true;
+}
+
+
 
 
 BOOL WmTabCommand_AddFunction(HWND, UINT message, WPARAM wParam, LPARAM lParam)
@@ -226,19 +230,22 @@ BOOL WmTabCommand_AddFunction(HWND, UINT message, WPARAM wParam, LPARAM lParam)
 	
 		HWND list = GetDlgItem(hWnd, IDC_FUNCTIONS_LIST);
 
+		// the list doesn't hold the table while it's being changed
+		rows.Reset();
 		GetPrgRes()->GetThreadController()->StopCalculating();
 		code = GetPrgRes()->GetFunctions()->Add(name, value, parameters);
 		GetPrgRes()->FunctionsChanged();
 		GetPrgRes()->GetThreadController()->StartCalculating();
 
 		if( code != ttmath::err_ok )
+		{
+			FillUpList(list, "");
 			ShowError(hWnd, code);
+		}
 		else
 		{
-			int id = AddNewItemToFunctionList(list, name, value, parameters);
-			Variables::SelectOnlyOneItem(list,id);
-			GetPrgRes()->ReadVariablesFunctionsFromFile();
-			GetPrgRes()->SaveToFile();
+			GetPrgRes()->SaveFunctionToFile(name);
+			FillUpList(list, name);
 		}
 
 	}
@@ -267,29 +274,21 @@ adding  = false;
 	if( id == -1 )
 		return true;
 
-	const int buffer_size = 300;
-	char * buffer = new char[buffer_size];
 	std::string old_name;
 	ttmath::ErrorCode code;
 
 	caption = GetPrgRes()->GetLanguages()->GuiMessage(Languages::dialog_box_edit_function_caption);
 	
-	ListView_GetItemText(list,id,0,buffer, buffer_size);
-	old_name = name = buffer;
-
-	ListView_GetItemText(list,id,1,buffer, buffer_size);
-	parameters = atoi(buffer);
-
-	ListView_GetItemText(list,id,2,buffer, buffer_size);
-	value = buffer;
-
-	delete [] buffer;
+	old_name = name = rows.Row(id)->first;
+	parameters      = rows.Row(id)->second.param;
+	value           = rows.Row(id)->second.value;
 
 	do
 	{
 		if( !DialogBox(GetPrgRes()->GetInstance(), MAKEINTRESOURCE(IDD_DIALOG_ADD_FUNCTION), hWnd, DialogProcFunction) )
 			break;
 
+		rows.Reset();
 		GetPrgRes()->GetThreadController()->StopCalculating();
 
 		// firstly we're trying to change the name
@@ -302,12 +301,17 @@ adding  = false;
 		GetPrgRes()->GetThreadController()->StartCalculating();
 
 		if( code != ttmath::err_ok )
+		{
+			FillUpList(list, old_name);
 			ShowError(list, code);
+		}
 		else
 		{
-			ChangeItemInFunctionList(list, id, old_name, name, value, parameters);
-			GetPrgRes()->ReadVariablesFunctionsFromFile();
-			GetPrgRes()->SaveToFile();
+			if( old_name != name )
+				GetPrgRes()->SaveFunctionToFile(old_name);
+
+			GetPrgRes()->SaveFunctionToFile(name);
+			FillUpList(list, name);
 		}
 	}
 	while( code != ttmath::err_ok );
@@ -337,32 +341,27 @@ int items = ListView_GetSelectedCount(list);
 	}
 
 	int id;
-	const int buffer_size = 300;
-	char * buffer = new char[buffer_size];
+	std::vector<std::string> names;
 	bool all_deleted = true;
 
-	GetPrgRes()->ReadVariablesFunctionsFromFile();
+	// the rows point into the current table so the names are copied first
+	for( id = Variables::GetSelectedItem(list) ; id != -1 ; id = ListView_GetNextItem(list, id, LVNI_SELECTED) )
+		names.push_back( rows.Row(id)->first );
+
+	rows.Reset();
 	GetPrgRes()->GetThreadController()->StopCalculating();
 
-	for( id = ListView_GetItemCount(list)-1 ; id!=-1 ; --id )
-	{
-		if( ListView_GetItemState(list, id, LVIS_SELECTED) == LVIS_SELECTED )
-		{
-			ListView_GetItemText(list,id,0,buffer,buffer_size);
-			if( GetPrgRes()->GetFunctions()->Delete(buffer) != ttmath::err_ok )
-				all_deleted = false;
-			else
-				ListView_DeleteItem(list, id);
+	for(size_t i=0 ; i<names.size() ; ++i)
+		if( GetPrgRes()->GetFunctions()->Delete(names[i]) != ttmath::err_ok )
+			all_deleted = false;
 
-			GetPrgRes()->FunctionsChanged();
-		}
-	}
-	
-	
+	GetPrgRes()->FunctionsChanged();
 	GetPrgRes()->GetThreadController()->StartCalculating();
-	GetPrgRes()->SaveToFile();
 
-	delete [] buffer;
+	for(size_t i=0 ; i<names.size() ; ++i)
+		GetPrgRes()->SaveFunctionToFile(names[i]);
+
+	FillUpList(list, "");
 
 	if( !all_deleted )
 		// there are some items which we've not deleted
@@ -491,6 +491,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(list_functions_header_1,"Name");
 	InsertGuiPair(list_functions_header_2,"Parameters");
 	InsertGuiPair(list_functions_header_3,"Value");
+	InsertGuiPair(list_filter,"Filter");
 
 	InsertGuiPair(button_add,"Add");
 	InsertGuiPair(button_edit,"Edit");
@@ -502,6 +503,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(tab_precision,"Precision");
 	InsertGuiPair(tab_display,"Display");
 	InsertGuiPair(tab_convert,"Convert");
+	InsertGuiPair(tab_tabulation,"Table");
 
 	InsertGuiPair(radio_precision_1,"Small - 96 bits for the mantissa, 32 bits for the exponent");
 	InsertGuiPair(radio_precision_2,"Medium - 512 bits for the mantissa, 64 bits for the exponent");
@@ -543,6 +545,14 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(convert_output,			"Output");
 	InsertGuiPair(convert_dynamic_output,	"Auto prefix");
 
+	InsertGuiPair(tabulation_variable,		"Variable");
+	InsertGuiPair(tabulation_start,			"Start");
+	InsertGuiPair(tabulation_step,			"Step");
+	InsertGuiPair(tabulation_count,			"Points");
+	InsertGuiPair(tabulation_calculate,		"Tabulate");
+	InsertGuiPair(tabulation_stop,			"Stop");
+	InsertGuiPair(tabulation_save,			"Save CSV");
+
 	InsertGuiPair(menu_view,				"&View");
 	InsertGuiPair(menu_edit,				"&Edit");
 	InsertGuiPair(menu_help,				"&Help");
@@ -662,6 +672,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(pad_menu_edit_paste,		"&Paste \tCtrl+V");
 	InsertGuiPair(pad_menu_edit_del,		"&Del \tDel");
 	InsertGuiPair(pad_menu_edit_select_all,	"Select &all \tCtrl+A");
+	InsertGuiPair(pad_menu_edit_recalculate,	"&Recalculate all \tF9");
 
 	InsertGuiPair(cannot_open_file,			"I cannot open the file");
 	InsertGuiPair(cannot_save_file,			"I cannot save to such a file");
@@ -700,6 +711,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(list_functions_header_1,"Nazwa");
 	InsertGuiPair(list_functions_header_2,"Parametry");
 	InsertGuiPair(list_functions_header_3,"Warto");
+	InsertGuiPair(list_filter,"Filtr");
 
 	InsertGuiPair(button_add,"Dodaj");
 	InsertGuiPair(button_edit,"Edytuj");
@@ -711,6 +723,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(tab_precision,"Precyzja");
 	InsertGuiPair(tab_display,"Wywietlanie");
 	InsertGuiPair(tab_convert,"Konwersja");
+	InsertGuiPair(tab_tabulation,"Tabela");
 
 	InsertGuiPair(radio_precision_1,"Maa - 96 bitowa mantysa, 32 bitowy wykadnik");
 	InsertGuiPair(radio_precision_2,"rednia - 512 bitowa mantysa, 64 bitowy wykadnik");
@@ -751,6 +764,14 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(convert_output,			"Wyjcie");
 	InsertGuiPair(convert_dynamic_output,	"Automatyczny prefiks");
 
+	InsertGuiPair(tabulation_variable,		"Zmienna");
+	InsertGuiPair(tabulation_start,			"Pocztek");
+	InsertGuiPair(tabulation_step,			"Krok");
+	InsertGuiPair(tabulation_count,			"Punkty");
+	InsertGuiPair(tabulation_calculate,		"Tabelaryzuj");
+	InsertGuiPair(tabulation_stop,			"Zatrzymaj");
+	InsertGuiPair(tabulation_save,			"Zapisz CSV");
+
 	InsertGuiPair(menu_view,				"&Widok");
 	InsertGuiPair(menu_edit,				"&Edycja");
 	InsertGuiPair(menu_help,				"&Pomoc");
@@ -869,6 +890,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(pad_menu_edit_paste,		"&Wklej \tCtrl+V");
 	InsertGuiPair(pad_menu_edit_del,		"&Usu \tDel");
 	InsertGuiPair(pad_menu_edit_select_all,	"Zaznacz wszystko \tCtrl+A");
+	InsertGuiPair(pad_menu_edit_recalculate,	"&Przelicz wszystko \tF9");
 
 	InsertGuiPair(cannot_open_file,			"Nie mog otworzy podanego pliku");
 	InsertGuiPair(cannot_save_file,			"Nie mog zapisa podanego pliku");
@@ -908,6 +930,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(list_functions_header_1,"Nombre");
 	InsertGuiPair(list_functions_header_2,"Param.");
 	InsertGuiPair(list_functions_header_3,"Valor");
+	InsertGuiPair(list_filter,"Filtro");
 
 	InsertGuiPair(button_add,"Aadir");
 	InsertGuiPair(button_edit,"Editar");
@@ -919,6 +942,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(tab_precision,"Precisin");
 	InsertGuiPair(tab_display,"Pantalla");
 	InsertGuiPair(tab_convert,"Convertir");
+	InsertGuiPair(tab_tabulation,"Table");
 
 	InsertGuiPair(radio_precision_1,"Pequeo - 96 bits para la mantisa, 32 bits para el exponente");
 	InsertGuiPair(radio_precision_2,"Mediano - 512 bits para la mantissa, 64 bits para el exponente");
@@ -961,6 +985,14 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(convert_output,			"Salida");
 	InsertGuiPair(convert_dynamic_output,	"Auto prefijo");
 
+	InsertGuiPair(tabulation_variable,		"Variable");
+	InsertGuiPair(tabulation_start,			"Start");
+	InsertGuiPair(tabulation_step,			"Step");
+	InsertGuiPair(tabulation_count,			"Points");
+	InsertGuiPair(tabulation_calculate,		"Tabulate");
+	InsertGuiPair(tabulation_stop,			"Stop");
+	InsertGuiPair(tabulation_save,			"Save CSV");
+
 	InsertGuiPair(menu_view,				"&Ver");
 	InsertGuiPair(menu_edit,				"&Editar");
 	InsertGuiPair(menu_help,				"&Ayuda");
@@ -1082,6 +1114,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(pad_menu_edit_paste,		"&Pegar \tCtrl+V");
 	InsertGuiPair(pad_menu_edit_del,		"&Borrar \tDel");
 	InsertGuiPair(pad_menu_edit_select_all,	"Seleccionar &todo \tCtrl+A");
+	InsertGuiPair(pad_menu_edit_recalculate,	"&Recalcular todo \tF9");
 
 	InsertGuiPair(cannot_open_file,			"I cannot open the file");
 	InsertGuiPair(cannot_save_file,			"I cannot save to such a file");
@@ -1120,6 +1153,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(list_functions_header_1,"Navn");
 	InsertGuiPair(list_functions_header_2,"Param.");
 	InsertGuiPair(list_functions_header_3,"Vrdi");
+	InsertGuiPair(list_filter,"Filter");
 
 	InsertGuiPair(button_add,"Tilfj");
 	InsertGuiPair(button_edit,"Rediger");
@@ -1131,6 +1165,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(tab_precision,"Prcision");
 	InsertGuiPair(tab_display,"Visning");
 	InsertGuiPair(tab_convert,"Konverter");
+	InsertGuiPair(tab_tabulation,"Table");
 
 	InsertGuiPair(radio_precision_1,"Lille - 96 bits for mantissen, 32 bits for exponenten");
 	InsertGuiPair(radio_precision_2,"Mellem - 512 bits for mantissen, 64 bits for exponenten");
@@ -1173,6 +1208,14 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(convert_output,			"Udput");
 	InsertGuiPair(convert_dynamic_output,	"Auto prfix");
 
+	InsertGuiPair(tabulation_variable,		"Variable");
+	InsertGuiPair(tabulation_start,			"Start");
+	InsertGuiPair(tabulation_step,			"Step");
+	InsertGuiPair(tabulation_count,			"Points");
+	InsertGuiPair(tabulation_calculate,		"Tabulate");
+	InsertGuiPair(tabulation_stop,			"Stop");
+	InsertGuiPair(tabulation_save,			"Save CSV");
+
 	InsertGuiPair(menu_view,				"&Vis");
 	InsertGuiPair(menu_edit,				"&Rediger");
 	InsertGuiPair(menu_help,				"&Hjlp");
@@ -1292,6 +1335,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(pad_menu_edit_paste,		"&St ind \tCtrl+V");
 	InsertGuiPair(pad_menu_edit_del,		"&Del \tDel");
 	InsertGuiPair(pad_menu_edit_select_all,	"Marker &alt \tCtrl+A");
+	InsertGuiPair(pad_menu_edit_recalculate,	"&Genberegn alt \tF9");
 
 	InsertGuiPair(cannot_open_file,			"I cannot open the file");
 	InsertGuiPair(cannot_save_file,			"I cannot save to such a file");
@@ -1330,6 +1374,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(list_functions_header_1,"");
 	InsertGuiPair(list_functions_header_2,"");
 	InsertGuiPair(list_functions_header_3,"ʽ");
+	InsertGuiPair(list_filter,"Filter");
 
 	InsertGuiPair(button_add,"");
 	InsertGuiPair(button_edit,"༭");
@@ -1341,6 +1386,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(tab_precision,"");
 	InsertGuiPair(tab_display,"ʾ");
 	InsertGuiPair(tab_convert,"ת");
+	InsertGuiPair(tab_tabulation,"Table");
 
 	InsertGuiPair(radio_precision_1,"С -   96 λ β,  32λ ָ");
 	InsertGuiPair(radio_precision_2," -  512 λ β,  64λ ָ");
@@ -1382,6 +1428,14 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(convert_output,			"");
 	InsertGuiPair(convert_dynamic_output,	"Զ");
 
+	InsertGuiPair(tabulation_variable,		"Variable");
+	InsertGuiPair(tabulation_start,			"Start");
+	InsertGuiPair(tabulation_step,			"Step");
+	InsertGuiPair(tabulation_count,			"Points");
+	InsertGuiPair(tabulation_calculate,		"Tabulate");
+	InsertGuiPair(tabulation_stop,			"Stop");
+	InsertGuiPair(tabulation_save,			"Save CSV");
+
 	InsertGuiPair(menu_view,				"&鿴");
 	InsertGuiPair(menu_edit,				"&༭");
 	InsertGuiPair(menu_help,				"&");
@@ -1502,6 +1556,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(pad_menu_edit_paste,		"&ճ \tCtrl+V");
 	InsertGuiPair(pad_menu_edit_del,		"&ɾ \tDel");
 	InsertGuiPair(pad_menu_edit_select_all,	"&ȫѡ \tCtrl+A");
+	InsertGuiPair(pad_menu_edit_recalculate,	"&Recalculate all \tF9");
 
 	InsertGuiPair(cannot_open_file,			"δܴļ");
 	InsertGuiPair(cannot_save_file,			"ܱļ");
@@ -1541,6 +1596,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(list_functions_header_1,"");
 	InsertGuiPair(list_functions_header_2,"");
 	InsertGuiPair(list_functions_header_3,"");
+	InsertGuiPair(list_filter,"Filter");
 
 	InsertGuiPair(button_add,"");
 	InsertGuiPair(button_edit,"");
@@ -1552,6 +1608,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(tab_precision,"");
 	InsertGuiPair(tab_display,"");
 	InsertGuiPair(tab_convert,"");
+	InsertGuiPair(tab_tabulation,"Table");
 
 	InsertGuiPair(radio_precision_1," - 96   , 32    ");
 	InsertGuiPair(radio_precision_2," - 512   , 64    ");
@@ -1594,6 +1651,14 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(convert_output,			"");
 	InsertGuiPair(convert_dynamic_output,	"");
 
+	InsertGuiPair(tabulation_variable,		"Variable");
+	InsertGuiPair(tabulation_start,			"Start");
+	InsertGuiPair(tabulation_step,			"Step");
+	InsertGuiPair(tabulation_count,			"Points");
+	InsertGuiPair(tabulation_calculate,		"Tabulate");
+	InsertGuiPair(tabulation_stop,			"Stop");
+	InsertGuiPair(tabulation_save,			"Save CSV");
+
 	InsertGuiPair(menu_view,				"&");
 	InsertGuiPair(menu_edit,				"&");
 	InsertGuiPair(menu_help,				"&");
@@ -1717,6 +1782,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(pad_menu_edit_paste,		"& \tCtrl+V");
 	InsertGuiPair(pad_menu_edit_del,		"& \tDel");
 	InsertGuiPair(pad_menu_edit_select_all,	"&  \tCtrl+A");
+	InsertGuiPair(pad_menu_edit_recalculate,	"&Recalculate all \tF9");
 
 	InsertGuiPair(cannot_open_file,			"I cannot open the file");
 	InsertGuiPair(cannot_save_file,			"I cannot save to such a file");
@@ -1757,6 +1823,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(list_functions_header_1,"Namn");
 	InsertGuiPair(list_functions_header_2,"Param.");
 	InsertGuiPair(list_functions_header_3,"Vrde");
+	InsertGuiPair(list_filter,"Filter");
 
 	InsertGuiPair(button_add,"Lgga till");
 	InsertGuiPair(button_edit,"Redigera");
@@ -1768,6 +1835,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(tab_precision,"Precision");
 	InsertGuiPair(tab_display,"Visning");
 	InsertGuiPair(tab_convert,"Konvertera");
+	InsertGuiPair(tab_tabulation,"Table");
 
 	InsertGuiPair(radio_precision_1,"Liten - 96 bitar fr mantissan, 32 bitar fr exponenten");
 	InsertGuiPair(radio_precision_2,"Mellan - 512 bitar fr mantissan, 64 bitar fr exponenten");
@@ -1798,6 +1866,14 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(convert_input,			"Input");
 	InsertGuiPair(convert_output,			"Output");
 	InsertGuiPair(convert_dynamic_output,	"Auto prefix");
+
+	InsertGuiPair(tabulation_variable,		"Variable");
+	InsertGuiPair(tabulation_start,			"Start");
+	InsertGuiPair(tabulation_step,			"Step");
+	InsertGuiPair(tabulation_count,			"Points");
+	InsertGuiPair(tabulation_calculate,		"Tabulate");
+	InsertGuiPair(tabulation_stop,			"Stop");
+	InsertGuiPair(tabulation_save,			"Save CSV");
 	InsertGuiPair(display_grouping,			"Grouping");
 	InsertGuiPair(display_grouping_none,	"None");
 	InsertGuiPair(display_grouping_space,	"Space");
@@ -1927,6 +2003,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(pad_menu_edit_paste,		"&Paste \tCtrl+V");
 	InsertGuiPair(pad_menu_edit_del,		"&Del \tDel");
 	InsertGuiPair(pad_menu_edit_select_all,	"Select &all \tCtrl+A");
+	InsertGuiPair(pad_menu_edit_recalculate,	"&Berkna om allt \tF9");
 
 	InsertGuiPair(cannot_open_file,			"I cannot open the file");
 	InsertGuiPair(cannot_save_file,			"I cannot save to such a file");
@@ -1966,6 +2043,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(list_functions_header_1,"Nome");
 	InsertGuiPair(list_functions_header_2,"Param.");
 	InsertGuiPair(list_functions_header_3,"Valore");
+	InsertGuiPair(list_filter,"Filtro");
 
 	InsertGuiPair(button_add,"Aggiungi");
 	InsertGuiPair(button_edit,"Modifica");
@@ -1977,6 +2055,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(tab_precision,"Precisione");
 	InsertGuiPair(tab_display,"Display");
 	InsertGuiPair(tab_convert,"Conversione");
+	InsertGuiPair(tab_tabulation,"Tabella");
 
 	InsertGuiPair(radio_precision_1,"Piccola - 96 bit per la mantissa, 32 bit per l'esponente");
 	InsertGuiPair(radio_precision_2,"Media - 512 bit per la mantissa, 64 bit per l'esponente");
@@ -2018,6 +2097,14 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(convert_output,			"Output");
 	InsertGuiPair(convert_dynamic_output,	"Prefisso automatico");
 
+	InsertGuiPair(tabulation_variable,		"Variabile");
+	InsertGuiPair(tabulation_start,			"Inizio");
+	InsertGuiPair(tabulation_step,			"Passo");
+	InsertGuiPair(tabulation_count,			"Punti");
+	InsertGuiPair(tabulation_calculate,		"Tabula");
+	InsertGuiPair(tabulation_stop,			"Ferma");
+	InsertGuiPair(tabulation_save,			"Salva CSV");
+
 	InsertGuiPair(menu_view,				"&Vista");
 	InsertGuiPair(menu_edit,				"&Modifica");
 	InsertGuiPair(menu_help,				"&Aiuto");
@@ -2137,6 +2224,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(pad_menu_edit_paste,		"&Incolla \tCtrl+V");
 	InsertGuiPair(pad_menu_edit_del,		"&Elimina \tDel");
 	InsertGuiPair(pad_menu_edit_select_all,	"Seleziona &tutto \tCtrl+A");
+	InsertGuiPair(pad_menu_edit_recalculate,	"&Ricalcola tutto \tF9");
 
 	InsertGuiPair(cannot_open_file,			"Non posso aprire il file");
 	InsertGuiPair(cannot_save_file,			"Non posso salvare in tale file");
@@ -2175,6 +2263,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(list_functions_header_1,"Name");
 	InsertGuiPair(list_functions_header_2,"Parameter");
 	InsertGuiPair(list_functions_header_3,"Wert");
+	InsertGuiPair(list_filter,"Filter");
 
 	InsertGuiPair(button_add,"Hinzufgen");
 	InsertGuiPair(button_edit,"Bearbeiten");
@@ -2186,6 +2275,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(tab_precision,"Genauigkeit");
 	InsertGuiPair(tab_display,"Anzeige");
 	InsertGuiPair(tab_convert,"Konvertieren");
+	InsertGuiPair(tab_tabulation,"Tabelle");
 
 	InsertGuiPair(radio_precision_1,"Klein - 96 bit fr Mantisse, 32 bit fr Exponenten");
 	InsertGuiPair(radio_precision_2,"Mittel - 512 bit fr Mantisse, 64 bit fr Exponenten");
@@ -2226,6 +2316,14 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(convert_output,			"Ergebnis");
 	InsertGuiPair(convert_dynamic_output,	"Auto prfix");
 
+	InsertGuiPair(tabulation_variable,		"Variable");
+	InsertGuiPair(tabulation_start,			"Start");
+	InsertGuiPair(tabulation_step,			"Schritt");
+	InsertGuiPair(tabulation_count,			"Punkte");
+	InsertGuiPair(tabulation_calculate,		"Tabellieren");
+	InsertGuiPair(tabulation_stop,			"Anhalten");
+	InsertGuiPair(tabulation_save,			"CSV speichern");
+
 	InsertGuiPair(menu_view,				"&Ansicht");
 	InsertGuiPair(menu_edit,				"&Bearbeiten");
 	InsertGuiPair(menu_help,				"&Hilfe");
@@ -2345,6 +2443,7 @@ void Languages::InitGuiMessagesTab()
 	InsertGuiPair(pad_menu_edit_paste,		"&Einfgen \tStrg+V");
 	InsertGuiPair(pad_menu_edit_del,		"&Lschen \tEntf");
 	InsertGuiPair(pad_menu_edit_select_all,	"Alles a&uswhlen \tStrg+A");
+	InsertGuiPair(pad_menu_edit_recalculate,	"Alles &neu berechnen \tF9");
 
 	InsertGuiPair(cannot_open_file,			"Datei kann nicht geffnet werden");
 	InsertGuiPair(cannot_save_file,			"Datei kann nicht gespeichert werden");
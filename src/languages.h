@@ -74,6 +74,7 @@ public:
 		list_functions_header_1,
 		list_functions_header_2,
 		list_functions_header_3,
+		list_filter,
 		button_add,
 		button_edit,
 		button_delete,
@@ -84,6 +85,7 @@ public:
 		tab_precision,
 		tab_display,
 		tab_convert,
+		tab_tabulation,
 		radio_precision_1,
 		radio_precision_2,
 		radio_precision_3,
@@ -116,6 +118,13 @@ public:
 		convert_input,
 		convert_output,
 		convert_dynamic_output,
+		tabulation_variable,
+		tabulation_start,
+		tabulation_step,
+		tabulation_count,
+		tabulation_calculate,
+		tabulation_stop,
+		tabulation_save,
 		menu_view,
 		menu_edit,
 		menu_help,
@@ -191,6 +200,7 @@ public:
 		pad_menu_edit_paste,
 		pad_menu_edit_del,
 		pad_menu_edit_select_all,
+		pad_menu_edit_recalculate,
 		cannot_open_file,
 		cannot_save_file,
 		file_too_long,
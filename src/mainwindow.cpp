@@ -531,6 +531,8 @@ TCITEM tab_item;
 	tab_convert   = -1;
 	#endif
 
+	tab_tabulation = tab_inc++;
+
 	// this insertion must be in the ascending order
 	// (the second parameter of 'TabCtrl_InsertItem')
 	TabCtrl_InsertItem(hTab, tab_standard,  &tab_item);
@@ -547,6 +549,8 @@ TCITEM tab_item;
 	TabCtrl_InsertItem(hTab, tab_convert,   &tab_item);
 	#endif
 
+	TabCtrl_InsertItem(hTab, tab_tabulation, &tab_item);
+
 	WmInitDialogCreateTab(hTab, tab_standard,  IDD_DIALOG_STANDARD,  TabWindowProc);
 	WmInitDialogCreateTab(hTab, tab_variables, IDD_DIALOG_VARIABLES, TabWindowProc);
 	WmInitDialogCreateTab(hTab, tab_functions, IDD_DIALOG_FUNCTIONS, TabWindowProc);
@@ -561,6 +565,8 @@ TCITEM tab_item;
 	WmInitDialogCreateTab(hTab, tab_convert,   IDD_DIALOG_CONVERT,   TabWindowProc);
 	#endif
 
+	WmInitDialogCreateTab(hTab, tab_tabulation, IDD_DIALOG_TABULATION, TabWindowProc);
+
 	SetSizeOfDialogs();
 
 	SendMessage(GetPrgRes()->GetTabWindow(tab_variables), WM_INIT_TAB_VARIABLES, 0,0);
@@ -576,6 +582,8 @@ TCITEM tab_item;
 	SendMessage(GetPrgRes()->GetTabWindow(tab_convert),   WM_INIT_TAB_CONVERT,   0,0);
 	#endif
 
+	SendMessage(GetPrgRes()->GetTabWindow(tab_tabulation), WM_INIT_TAB_TABULATION, 0,0);
+
 	TabWindowFunctions::SetLanguage(hTab);
 
 	TabCtrl_SetCurSel(hTab, tab_standard);
@@ -743,6 +751,7 @@ POINT p;
 	TabWindowFunctions::SetSizeOfVariablesList(tab, cx, cy-p.y, borderx, bordery);
 	TabWindowFunctions::SetSizeOfFunctionsList(tab, cx, cy-p.y, borderx, bordery);
 	TabWindowFunctions::SetSizeOfConvertingLists(tab, cx, cy-p.y, borderx, bordery);
+	TabWindowFunctions::TabulationTab::SetSizeOfResult(tab, cx, cy-p.y, borderx, bordery);
 
 	if( fwSizeType != SIZE_MINIMIZED && fwSizeType != SIZE_MAXIMIZED &&
 		GetPrgRes()->GetView() != ProgramResources::view_compact )
@@ -1051,9 +1060,9 @@ BOOL WmCommand_InputEditNotify(HWND hWnd, UINT message, WPARAM wParam, LPARAM lP
 	if( HIWORD(wParam) != EN_CHANGE )
 		return false;
 
-	GetPrgRes()->GetThreadController()->StopCalculating();
+	// we don't wait for the second thread here (the newest input wins)
 	GetDlgItemText(hWnd,IDC_INPUT_EDIT, (char*)GetPrgRes()->GetBuffer(), GetPrgRes()->GetBufferSize());
-	GetPrgRes()->GetThreadController()->StartCalculating();
+	GetPrgRes()->GetThreadController()->PostInput( GetPrgRes()->GetBuffer() );
 
 return true;
 }
@@ -1243,6 +1252,42 @@ return true;
 }
 
 
+/*!
+	the second thread has put results into the queue
+
+	only the newest result is shown (older ones are skipped) and only if it's from
+	the current generation - if the user has typed something more then a result
+	of the newer input will come soon
+*/
+BOOL WmSetResult(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+ResultQueue * queue = GetPrgRes()->GetResultQueue();
+CalculationResult * result;
+
+	// results which will be put after this point will come with a new message
+	queue->Woken();
+
+	while( (result = queue->Front()) != 0 && queue->Size() > 1 )
+		queue->Pop();
+
+	if( !result )
+		return true;
+
+	if( result->generation == GetPrgRes()->GetThreadController()->GetGeneration() )
+	{
+		HWND conv_tab = GetPrgRes()->GetTabWindow(TabWindowFunctions::tab_convert);
+
+		SetDlgItemText(hWnd, IDC_OUTPUT_EDIT, result->output.c_str());
+		SetDlgItemText(conv_tab, IDC_EDIT_OUTPUT_INFO, result->convert_info.c_str());
+		WmSetLastError(hWnd, WM_SET_LAST_ERROR, (WPARAM)result->code, 0);
+	}
+
+	queue->Pop();
+
+return true;
+}
+
+
 void SetOutputEditLanguage(HWND hWnd)
 {
 	if( TabWindowFunctions::last_code != ttmath::err_ok )
@@ -1509,6 +1554,7 @@ void CreateMainMessagesTable(Messages<BOOL> & messages)
 	messages.Associate(WM_NOTIFY, WmNotify);
 	messages.Associate(WM_SIZING, WmSizing);
 	messages.Associate(WM_SET_LAST_ERROR, WmSetLastError);
+	messages.Associate(WM_SET_RESULT, WmSetResult);
 	messages.Associate(WM_HELP, WmHelp);
 	messages.Associate(WM_UPDATE_EXISTS, WmUpdateExists);
 }
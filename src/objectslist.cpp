@@ -0,0 +1,192 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "compileconfig.h"
+#include "objectslist.h"
+
+
+
+void ObjectsList::SetObjects(const ObjectsSnapshot & new_objects)
+{
+	objects = new_objects;
+	rows.clear();
+
+	if( !objects.Get() )
+		return;
+
+	for(CIterator i = objects->Begin() ; i != objects->End() ; ++i)
+		if( filter.empty() || Contains(i->first, filter) || Contains(i->second.value, filter) )
+			rows.push_back(i);
+}
+
+
+void ObjectsList::Reset()
+{
+	objects.Reset();
+	rows.clear();
+}
+
+
+bool ObjectsList::SetFilter(const std::string & new_filter)
+{
+std::string small;
+
+	for(size_t i=0 ; i<new_filter.size() ; ++i)
+		small += SmallLetter(new_filter[i]);
+
+	if( small == filter )
+		return false;
+
+	if( small.find(filter) != std::string::npos )
+	{
+		// each object which has the new filter has the old one too
+		filter = small;
+		Filter(filter);
+	}
+	else
+	{
+		filter = small;
+		SetObjects(objects);
+	}
+
+return true;
+}
+
+
+int ObjectsList::FindName(const std::string & name) const
+{
+size_t first = 0, last = rows.size();
+
+	// rows are sorted in the same way as the table
+	while( first < last )
+	{
+		size_t middle = first + (last - first) / 2;
+
+		if( rows[middle]->first < name )
+			first = middle + 1;
+		else
+			last = middle;
+	}
+
+	if( first < rows.size() && rows[first]->first == name )
+		return int(first);
+
+return -1;
+}
+
+
+int ObjectsList::FindPrefix(const std::string & prefix, int start, bool wrap) const
+{
+std::string small;
+size_t i;
+
+	for(i=0 ; i<prefix.size() ; ++i)
+		small += SmallLetter(prefix[i]);
+
+	if( start < 0 || size_t(start) >= rows.size() )
+		start = 0;
+
+	for(i=start ; i<rows.size() ; ++i)
+		if( BeginsWith(rows[i]->first, small) )
+			return int(i);
+
+	if( wrap )
+		for(i=0 ; i<size_t(start) ; ++i)
+			if( BeginsWith(rows[i]->first, small) )
+				return int(i);
+
+return -1;
+}
+
+
+void ObjectsList::Filter(const std::string & new_filter)
+{
+size_t i, len = 0;
+
+	for(i=0 ; i<rows.size() ; ++i)
+		if( Contains(rows[i]->first, new_filter) || Contains(rows[i]->second.value, new_filter) )
+			rows[len++] = rows[i];
+
+	rows.erase(rows.begin() + len, rows.end());
+}
+
+
+char ObjectsList::SmallLetter(char c)
+{
+	if( c>='A' && c<='Z' )
+		c = c - 'A' + 'a';
+
+return c;
+}
+
+
+/*!
+	'pattern' has small letters
+*/
+bool ObjectsList::Contains(const std::string & text, const std::string & pattern)
+{
+	if( pattern.size() > text.size() )
+		return false;
+
+	for(size_t i=0 ; i + pattern.size() <= text.size() ; ++i)
+	{
+		size_t x;
+
+		for(x=0 ; x<pattern.size() && SmallLetter(text[i+x]) == pattern[x] ; ++x);
+
+		if( x == pattern.size() )
+			return true;
+	}
+
+return false;
+}
+
+
+/*!
+	'prefix' has small letters
+*/
+bool ObjectsList::BeginsWith(const std::string & text, const std::string & prefix)
+{
+	if( prefix.size() > text.size() )
+		return false;
+
+	for(size_t i=0 ; i<prefix.size() ; ++i)
+		if( SmallLetter(text[i]) != prefix[i] )
+			return false;
+
+return true;
+}
@@ -0,0 +1,146 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef headerfileobjectslist
+#define headerfileobjectslist
+
+/*!
+	\file objectslist.h
+    \brief rows of the lists of variables and functions (the lists are virtual)
+*/
+
+#include "compileconfig.h"
+#include "objectssnapshot.h"
+#include <string>
+#include <vector>
+
+
+/*!
+	\brief rows of the list of variables or functions
+
+	the lists on the variables' and functions' tabs are virtual (owner-data) list views,
+	they don't keep any text, they only know how many rows there are and ask
+	for the text of a row when it is being drawn - this object gives them the rows
+
+	the rows point directly into a snapshot of the table (nothing is copied)
+	and they are sorted by names (in the order of the table), the snapshot should
+	be released by Reset() before the table is changed (otherwise the table is
+	shared and it is copied by the change), a filter can be set
+	and then only the objects which have the filter in their names or values
+	are shown (the case of letters doesn't matter)
+*/
+class ObjectsList
+{
+public:
+
+	typedef ttmath::Objects::CIterator CIterator;
+
+
+	/*!
+		taking a new snapshot of the table (after it has been changed),
+		the filter is applied again
+	*/
+	void SetObjects(const ObjectsSnapshot & objects);
+
+
+	/*!
+		releasing the snapshot, there are no rows until SetObjects() is called again
+	*/
+	void Reset();
+
+
+	/*!
+		setting the filter, an empty filter shows all objects
+
+		when the new filter contains the old one (the user has typed more
+		characters) only the current rows are checked, otherwise the whole
+		table is searched
+
+		it returns false if the filter has not changed
+	*/
+	bool SetFilter(const std::string & filter);
+
+
+	/*!
+		the number of rows shown
+	*/
+	size_t Size() const
+	{
+		return rows.size();
+	}
+
+
+	/*!
+		a row (index must be less than Size())
+	*/
+	CIterator Row(size_t index) const
+	{
+		return rows[index];
+	}
+
+
+	/*!
+		the index of a row with the given name or -1 if the name is not shown
+	*/
+	int FindName(const std::string & name) const;
+
+
+	/*!
+		the index of the first row (from 'start') whose name begins with 'prefix'
+		(the case doesn't matter), if 'wrap' is true the search continues from
+		the beginning, it returns -1 if there is not such a row
+	*/
+	int FindPrefix(const std::string & prefix, int start, bool wrap) const;
+
+
+private:
+
+	ObjectsSnapshot objects;
+	std::vector<CIterator> rows;
+
+	// the filter with small letters
+	std::string filter;
+
+	void Filter(const std::string & new_filter);
+
+	static char SmallLetter(char c);
+	static bool Contains(const std::string & text, const std::string & pattern);
+	static bool BeginsWith(const std::string & text, const std::string & prefix);
+};
+
+
+#endif
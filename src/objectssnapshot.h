@@ -0,0 +1,228 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef headerfileobjectssnapshot
+#define headerfileobjectssnapshot
+
+/*!
+	\file objectssnapshot.h
+    \brief a reference-counted table of variables or functions (copy-on-write)
+*/
+
+#include "compileconfig.h"
+#include <ttmath/ttmathobjects.h>
+
+#ifdef _MSC_VER
+#include <windows.h>
+#endif
+
+
+/*!
+	\brief a reference-counted table of variables or functions
+
+	copying this object only increments a counter so the second thread can take
+	the current state of variables and functions in a constant time (it was
+	copying the whole tables before)
+
+	the table is shared between all copies and it can be read by many threads
+	at the same time, if you want to change it call Change() - the table is copied
+	only if someone else is still holding it, the other holders see their old
+	table until they release it
+
+	the counter is changed atomically but one object (a handle) should not be used
+	by two threads at the same time, each thread has its own copy
+*/
+class ObjectsSnapshot
+{
+public:
+
+
+	/*!
+		a new empty table
+	*/
+	ObjectsSnapshot()
+	{
+		node = new Node();
+	}
+
+
+	/*!
+		the table is shared (it is not copied)
+	*/
+	ObjectsSnapshot(const ObjectsSnapshot & s)
+	{
+		node = s.node;
+		AddRef(node);
+	}
+
+
+	ObjectsSnapshot & operator=(const ObjectsSnapshot & s)
+	{
+		// the order matters when assigning to itself
+		AddRef(s.node);
+		Release(node);
+		node = s.node;
+
+	return *this;
+	}
+
+
+	~ObjectsSnapshot()
+	{
+		Release(node);
+	}
+
+
+	/*!
+		the table for reading
+		(it is null only after Reset())
+	*/
+	const ttmath::Objects * Get() const
+	{
+		return node ? &node->objects : 0;
+	}
+
+
+	const ttmath::Objects * operator->() const
+	{
+		return &node->objects;
+	}
+
+
+	/*!
+		the table for changing
+
+		if the table is shared it is copied first so the other holders are not
+		disturbed, the returned pointer is valid until this handle is copied
+		again or destroyed
+	*/
+	ttmath::Objects * Change()
+	{
+		if( !node )
+		{
+			node = new Node();
+		}
+		else
+		if( IsShared() )
+		{
+			Node * copy = new Node(node->objects);
+			Release(node);
+			node = copy;
+		}
+
+	return &node->objects;
+	}
+
+
+	/*!
+		releasing the table, after this call Get() returns null
+		(the table is deleted if nobody else is holding it)
+	*/
+	void Reset()
+	{
+		Release(node);
+		node = 0;
+	}
+
+
+	/*!
+		true if another handle points to the same table
+	*/
+	bool IsShared() const
+	{
+		// a full barrier, if the other thread has just released the table
+		// we must not start writing before its last reading
+		#ifdef _MSC_VER
+			return node && InterlockedCompareExchange(&node->refs, 0, 0) != 1;
+		#else
+			return node && __sync_add_and_fetch(&node->refs, 0) != 1;
+		#endif
+	}
+
+
+private:
+
+
+	struct Node
+	{
+		ttmath::Objects objects;
+		long refs;
+
+		Node() : refs(1)
+		{
+		}
+
+		Node(const ttmath::Objects & o) : objects(o), refs(1)
+		{
+		}
+	};
+
+	Node * node;
+
+
+	static void AddRef(Node * n)
+	{
+		if( !n )
+			return;
+
+		#ifdef _MSC_VER
+			InterlockedIncrement(&n->refs);
+		#else
+			__sync_add_and_fetch(&n->refs, 1);
+		#endif
+	}
+
+
+	static void Release(Node * n)
+	{
+		if( !n )
+			return;
+
+		#ifdef _MSC_VER
+			long refs = InterlockedDecrement(&n->refs);
+		#else
+			long refs = __sync_sub_and_fetch(&n->refs, 1);
+		#endif
+
+		if( refs == 0 )
+			delete n;
+	}
+
+};
+
+
+#endif
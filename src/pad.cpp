@@ -43,54 +43,75 @@
 #include "resource.h"
 #include "messages.h"
 #include "bigtypes.h"
+#include "evaluator.h"
+#include "symboltable.h"
+#include "stopflag.h"
+#include "worksheet.h"
+#include "textfile.h"
 #include "pad.h"
 
+#include <process.h>
+
 
 namespace Pad
 {
 HWND edit;
 WNDPROC old_edit_proc;
 std::string parse_string;
-int precision;
 HFONT font;
 
-int  base_input;
-int  base_output;
-bool always_scientific;
-int  when_scientific;
-int  rounding;
-bool remove_zeroes;
-int  angle_deg_rad_grad;
+EvaluatorSettings settings;
+Evaluator evaluator;
+
+// hashed names of variables and functions and the objects used by the current line
+SymbolTable symbols;
+ttmath::Objects used_variables, used_functions;
+int symbols_variables_id = -1;
+int symbols_functions_id = -1;
+
+/*!
+	the line is prepared by the gui thread and then only the pad thread uses it
+	(and the evaluator with the tables of used objects) until WM_PAD_FINISHED
+	is posted, only one line is calculated at a time
+*/
+struct Job
+{
+	// true if all lines are calculated by the worksheet
+	// (then 'line' is the whole text and 'result' is the annotated text)
+	bool whole_document;
+
+	std::string line;
 
-char decimal_point;
-char grouping;
-char input_comma1;
-char input_comma2;
-char param_sep;
+	// where the result should be put (just after the line),
+	// the text can be changed during calculating so it is only a hint
+	DWORD position;
 
-int grouping_digits;
+	// the number of the job, messages of cancelled jobs are ignored
+	unsigned int id;
 
-Languages::Country country;
+	ttmath::ErrorCode code;
+	bool calculated;
+	std::string result;
 
-int last_variables_id;
-int last_functions_id;
-ttmath::Objects * variables;
-ttmath::Objects * functions;
+	// the worksheet uses all variables and functions
+	ObjectsSnapshot variables;
+	ObjectsSnapshot functions;
+	int variables_id;
+	int functions_id;
+};
 
-ttmath::ErrorCode code;
-bool calculated;
 
-std::string res, res2;
-std::string file_name;
+Job job;
+Worksheet worksheet;
+HANDLE thread = 0;
+StopFlag stop;
+unsigned int last_job_id = 0;
 
+// 65535 - 64KB
+const size_t max_text_size = 65535 - 5;
 
-#ifndef TTCALC_PORTABLE
-	ttmath::Parser<TTMathBig1> parser1;
-	ttmath::Parser<TTMathBig2> parser2;
-	ttmath::Parser<TTMathBig3> parser3;
-#else
-	ttmath::Parser<TTMathBig1> parser1;
-#endif
+std::string res;
+std::string file_name;
 
 
 void PutChars(const char * str)
@@ -105,83 +126,6 @@ void PutChars(std::string & str)
 }
 
 
-void PutOverflowMsg()
-{
-	PutChars(GetPrgRes()->GetLanguages()->ErrorMessage(country, ttmath::err_overflow));
-	PutChars("\r\n");
-}
-
-
-template<typename ValueType>
-void PutResultFromParser(ttmath::Parser<ValueType> & matparser)
-{
-unsigned int i = 0;
-
-	res.clear();
-	res2.clear();
-
-	for(i=0 ; i<matparser.stack.size() ; ++i)
-	{
-		try
-		{
-			ValueType result = matparser.stack[i].value;
-
-			ttmath::Conv conv;
-
-			conv.base         = base_output;
-			conv.scient       = always_scientific;
-			conv.scient_from  = when_scientific;
-			conv.round        = rounding;
-			conv.trim_zeroes  = remove_zeroes;
-			conv.comma        = decimal_point;
-			conv.group        = grouping;
-			conv.group_digits = grouping_digits;
-			
-			if( result.ToString(res2, conv) )
-				res2 = GetPrgRes()->GetLanguages()->GuiMessage(country, Languages::overflow_during_printing);
-		}
-		catch(...)
-		{
-			res2 = GetPrgRes()->GetLanguages()->ErrorMessage(country, ttmath::err_internal_error);
-		}
-
-		res += res2;
-
-		if( i < matparser.stack.size()-1 )
-			res += "\r\n";
-	}
-
-	res += ' ';
-	PutChars(res);
-}
-
-
-void PutResult()
-{
-	#ifndef TTCALC_PORTABLE
-
-		switch( precision )
-		{
-		case 0:
-			PutResultFromParser(parser1);
-			break;
-
-		case 1:
-			PutResultFromParser(parser2);
-			break;
-
-		default:
-			PutResultFromParser(parser3);
-			break;
-		}
-
-	#else
-
-		PutResultFromParser(parser1);
-
-	#endif
-}
-
 
 
 // line - index of a line -- as you see it on the edit control
@@ -235,88 +179,355 @@ int line;
 }
 
 
-template<class ValueType>
-void ParseString(ttmath::Parser<ValueType> & matparser)
+void SetParameters()
 {
-	matparser.SetBase(base_input);
-	matparser.SetDegRadGrad(angle_deg_rad_grad);
-	matparser.SetComma(input_comma1, input_comma2);
-	matparser.SetGroup(grouping);
-	matparser.SetParamSep(param_sep);
+	GetPrgRes()->GetEvaluatorSettings(settings);
 
-	matparser.SetVariables(variables);
-	matparser.SetFunctions(functions);
+	// we're in the gui thread so the tables cannot change while we're building
+	// the symbol table and we don't have to hold snapshots of them
+	if( symbols_variables_id != GetPrgRes()->GetVariablesId() ||
+		symbols_functions_id != GetPrgRes()->GetFunctionsId() )
+	{
+		symbols.Build(GetPrgRes()->GetVariablesSnapshot().Get(), GetPrgRes()->GetFunctionsSnapshot().Get());
+		symbols_variables_id = GetPrgRes()->GetVariablesId();
+		symbols_functions_id = GetPrgRes()->GetFunctionsId();
+	}
 
-	code = matparser.Parse(parse_string.c_str());
+	symbols.Select(parse_string.c_str(), used_variables, used_functions);
 
-	calculated = matparser.Calculated();
+	evaluator.SetVariables(&used_variables);
+	evaluator.SetFunctions(&used_functions);
+	evaluator.SetObjectsId(GetPrgRes()->GetVariablesId(), GetPrgRes()->GetFunctionsId());
+	evaluator.SetLanguages(GetPrgRes()->GetLanguages());
 }
 
+	
+unsigned __stdcall PadProc(void *)
+{
+	if( job.whole_document )
+	{
+		worksheet.SetThreads(0);
+		worksheet.SetStopObject(&stop);
+		worksheet.SetObjectsId(job.variables_id, job.functions_id);
+		worksheet.SetText(job.line);
 
-void SetParameters()
+		job.code = worksheet.Run(settings, *job.variables.Get(), *job.functions.Get(), GetPrgRes()->GetLanguages());
+
+		if( job.code == ttmath::err_ok )
+			worksheet.Annotate(job.result, "\r\n");
+
+		PostMessage(GetPrgRes()->GetPadWindow(), WM_PAD_FINISHED, job.id, 0);
+		return 0;
+	}
+
+	job.code       = evaluator.Parse(job.line.c_str(), settings);
+	job.calculated = evaluator.Calculated();
+
+	if( job.code==ttmath::err_ok && job.calculated )
+	{
+		evaluator.PrintResult(job.result, "\r\n");
+		job.result += ' ';
+	}
+
+	PostMessage(GetPrgRes()->GetPadWindow(), WM_PAD_FINISHED, job.id, 0);
+
+return 0;
+}
+
+
+void WaitForJob()
+{
+	if( !thread )
+		return;
+
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+	thread = 0;
+}
+
+
+/*!
+	the result should be put just after the line which was calculated,
+	the line could have been moved in the meantime so we're looking for it
+	and if there are more such lines the nearest to the remembered position is taken,
+	returning false if the line does not exist any more
+*/
+bool FindResultPosition(const char * buf, DWORD & position)
 {
-	base_input         = GetPrgRes()->GetBaseInput();
-	base_output        = GetPrgRes()->GetBaseOutput();
-	always_scientific  = GetPrgRes()->GetDisplayAlwaysScientific();
-	when_scientific    = GetPrgRes()->GetDisplayWhenScientific();
-	rounding           = GetPrgRes()->GetDisplayRounding();
-	precision          = GetPrgRes()->GetPrecision();
-	remove_zeroes      = GetPrgRes()->GetRemovingZeroes();
-	angle_deg_rad_grad = GetPrgRes()->GetDegRadGrad();
-	country            = GetPrgRes()->GetLanguages()->GetCurrentLanguage();
-	decimal_point      = GetPrgRes()->GetDecimalPointChar();
-	grouping           = GetPrgRes()->GetGroupingChar();
-	grouping_digits    = GetPrgRes()->GetGroupingDigits();
-	param_sep          = GetPrgRes()->GetParamSepChar();
+std::string text(buf);
+std::string line = job.line + "\r\n";
+size_t i, end, best = std::string::npos;
+size_t distance, best_distance = 0;
 
-	GetPrgRes()->GetInputDecimalPointChar(&input_comma1, &input_comma2);
+	for( i = text.find(line) ; i != std::string::npos ; i = text.find(line, i + 1) )
+	{
+		if( i > 0 && text[i-1] != '\n' )
+			continue;
+
+		end      = i + line.size();
+		distance = (end > job.position) ? end - job.position : job.position - end;
 
-	variables = GetPrgRes()->GetVariables();
-	functions = GetPrgRes()->GetFunctions();
+		if( best == std::string::npos || distance < best_distance )
+		{
+			best          = end;
+			best_distance = distance;
+		}
+	}
+
+	if( best == std::string::npos )
+		return false;
+
+	position = DWORD(best);
+
+return true;
 }
 
-	
-void ParseString()
+
+bool FindResultPosition(DWORD & position)
+{
+bool found = false;
+HLOCAL handle = (HLOCAL)SendMessage(edit, EM_GETHANDLE, 0, 0);
+
+	if( handle == 0 )
+		// something wrong
+		return false;
+
+	const char * buf = (const char*)LocalLock(handle);
+
+	if( buf )
+		found = FindResultPosition(buf, position);
+
+	LocalUnlock(handle);
+
+return found;
+}
+
+
+/*!
+	putting the text at the position without changing the selection
+	(if the caret is at the position it is moved after the text as when
+	the result was put synchronously)
+*/
+void PutChars(DWORD position, const std::string & text)
+{
+DWORD sel_start, sel_end;
+
+	SendMessage(edit, EM_GETSEL, (WPARAM)&sel_start, (LPARAM)&sel_end);
+	SendMessage(edit, EM_SETSEL, position, position);
+	PutChars(text.c_str());
+
+	if( sel_start >= position )
+		sel_start += DWORD(text.size());
+
+	if( sel_end >= position )
+		sel_end += DWORD(text.size());
+
+	SendMessage(edit, EM_SETSEL, sel_start, sel_end);
+	SendMessage(edit, EM_SCROLLCARET, 0, 0);
+}
+
+
+/*!
+	waiting for the thread and putting the result of the last job
+	(or an error message if the calculation was broken or there was an overflow)
+*/
+void FinishDocument();
+
+
+void FinishJob()
+{
+DWORD position;
+
+	WaitForJob();
+
+	if( job.whole_document )
+	{
+		FinishDocument();
+		return;
+	}
+
+	if( job.code == ttmath::err_overflow || job.code == ttmath::err_interrupt )
+	{
+		job.result  = GetPrgRes()->GetLanguages()->ErrorMessage(settings.country, job.code);
+		job.result += "\r\n";
+	}
+
+	if( !job.result.empty() && FindResultPosition(position) )
+		PutChars(position, job.result);
+
+	job.result.clear();
+}
+
+
+/*!
+	breaking the calculation, its result is not put
+*/
+void CancelJob()
+{
+	if( !thread )
+		return;
+
+	stop.Stop();
+	WaitForJob();
+	job.result.clear();
+	job.variables.Reset();
+	job.functions.Reset();
+}
+
+
+/*!
+	breaking the calculation, the information about it is put after the line
+*/
+void BreakJob()
+{
+	if( !thread )
+		return;
+
+	stop.Stop();
+	FinishJob();
+}
+
+
+/*!
+	the line is calculated by the pad thread so the edit can be used in the meantime,
+	if a line is still calculated it is broken
+*/
+void StartJob()
+{
+unsigned int thread_id;
+
+	job.id         = ++last_job_id;
+	job.code       = ttmath::err_ok;
+	job.calculated = false;
+	job.result.clear();
+
+	stop.Start();
+
+	thread = (HANDLE)_beginthreadex(0, 0, PadProc, 0, 0, &thread_id);
+
+	if( !thread )
+	{
+		// calculating in this thread then
+		PadProc(0);
+		FinishJob();
+	}
+}
+
+
+void ParseString(DWORD position)
 {
 	if( parse_string.empty() )
 		return;
-	
+
+	BreakJob();
 	SetParameters();
+	evaluator.SetStopObject(&stop);
 
-	try
-	{
-	#ifndef TTCALC_PORTABLE
+	job.whole_document = false;
+	job.line           = parse_string;
+	job.position       = position;
 
-		switch( precision )
-		{
-		case 0:
-			ParseString(parser1);
-			break;
+	StartJob();
+}
 
-		case 1:
-			ParseString(parser2);
-			break;
 
-		default:
-			ParseString(parser3);
-			break;
-		}
+void GetText(std::string & text)
+{
+	text.clear();
+	HLOCAL handle = (HLOCAL)SendMessage(edit, EM_GETHANDLE, 0, 0);
 
-	#else
-		ParseString(parser1);
-	#endif
+	if( handle == 0 )
+		// something wrong
+		return;
+
+	const char * buf = (const char*)LocalLock(handle);
+
+	if( buf )
+		text = buf;
+
+	LocalUnlock(handle);
+}
+
+
+/*!
+	lines are calculated by the worksheet (by many threads), only lines which
+	have changed since the last time are calculated again (and lines which use them),
+	the text is replaced with the annotated one when they are finished
+*/
+void RecalculateDocument()
+{
+	BreakJob();
+	GetPrgRes()->GetEvaluatorSettings(settings);
+
+	job.whole_document = true;
+	job.position       = 0;
+	job.variables      = GetPrgRes()->GetVariablesSnapshot();
+	job.functions      = GetPrgRes()->GetFunctionsSnapshot();
+	job.variables_id   = GetPrgRes()->GetVariablesId();
+	job.functions_id   = GetPrgRes()->GetFunctionsId();
+	GetText(job.line);
+
+	StartJob();
+}
+
+
+/*!
+	the annotated text is put only if the text has not been changed during calculating,
+	the caret stays at the end of the same line
+*/
+void FinishDocument()
+{
+std::string text;
+
+	// the gui can change variables and functions without copying them now
+	job.variables.Reset();
+	job.functions.Reset();
+
+	GetText(text);
+
+	if( job.code != ttmath::err_ok || text != job.line )
+	{
+		job.result.clear();
+		return;
 	}
-	catch(...)
+
+	if( job.result.size() > max_text_size )
 	{
-		code = ttmath::err_internal_error;
+		Languages * lang = GetPrgRes()->GetLanguages();
+		MessageBox(GetPrgRes()->GetPadWindow(), lang->GuiMessage(Languages::file_too_long),
+					lang->GuiMessage(Languages::message_box_error_caption), MB_ICONERROR);
+		job.result.clear();
+		return;
 	}
 
+	int first_line = SendMessage(edit, EM_GETFIRSTVISIBLELINE, 0, 0);
+	int line       = SendMessage(edit, EM_LINEFROMCHAR, -1, 0);
 
-	if( code==ttmath::err_ok && calculated )
-		PutResult();
-	else
-	if( code==ttmath::err_overflow )
-		PutOverflowMsg();
+	SendMessage(edit, EM_SETSEL, 0, -1);
+	PutChars(job.result.c_str());
+	job.result.clear();
+
+	int index = SendMessage(edit, EM_LINEINDEX, line, 0);
+
+	if( index >= 0 )
+	{
+		index += SendMessage(edit, EM_LINELENGTH, index, 0);
+		SendMessage(edit, EM_SETSEL, index, index);
+	}
+
+	SendMessage(edit, EM_LINESCROLL, 0, first_line - SendMessage(edit, EM_GETFIRSTVISIBLELINE, 0, 0));
+}
+
+
+LRESULT PadFinished(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
+{
+	// the message of a job which has been broken or cancelled
+	if( !thread || wParam != job.id )
+		return 0;
+
+	FinishJob();
+
+return 0;
 }
 
 
@@ -334,7 +545,8 @@ DWORD sel_start, sel_end;
 		return res;
 
 	GetParseString();
-	ParseString();
+	SendMessage(edit, EM_GETSEL, (WPARAM)&sel_start, (LPARAM)&sel_end);
+	ParseString(sel_start);
 
 return res;
 }
@@ -350,6 +562,20 @@ LRESULT EditSubclass(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 		{
 			return EditReturnPressed(hwnd, msg, wParam, lParam);
 		}
+		else
+		if( wParam == VK_ESCAPE && thread )
+		{
+			BreakJob();
+			return 0;
+		}
+		break;
+
+	case WM_KEYDOWN:
+		if( wParam == VK_F9 )
+		{
+			RecalculateDocument();
+			return 0;
+		}
 		break;
 	}
 
@@ -397,6 +623,7 @@ HMENU menu = GetMenu(hWnd);
 	SetMenuLanguageItem(menu, MENUPAD_EDIT_PASTE,		Languages::pad_menu_edit_paste);
 	SetMenuLanguageItem(menu, MENUPAD_EDIT_DEL,			Languages::pad_menu_edit_del);
 	SetMenuLanguageItem(menu, MENUPAD_EDIT_SELECTALL,	Languages::pad_menu_edit_select_all);
+	SetMenuLanguageItem(menu, MENUPAD_EDIT_RECALCULATE,	Languages::pad_menu_edit_recalculate);
 
 	DrawMenuBar(hWnd);
 }
@@ -415,9 +642,8 @@ LRESULT PadCreate(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 
 	old_edit_proc = (WNDPROC)SetWindowLong(edit, GWL_WNDPROC, (LONG)EditSubclass);
 
-	// 65535 - 64KB 
 	// we're using some kind of messages which operates only on 64KB
-	SendMessage(edit, EM_SETLIMITTEXT, 65535 - 5, 0);
+	SendMessage(edit, EM_SETLIMITTEXT, max_text_size, 0);
 
 	if( font != 0 )
 		SendMessage(edit, WM_SETFONT, (WPARAM)font, 0);
@@ -524,80 +750,43 @@ return false;
 }
 
 
-// testing files which have only one 10 at the end of a line (unix mode)
-void CorrectUnixMode()
-{
-bool was_r = false;
-
-	for(size_t i=0 ; i<res.size() ; ++i)
-	{
-		if( res[i]==10 && !was_r )
-		{
-			res.insert(res.begin()+i, 13);
-			++i;
-		}
-		else
-		{
-			was_r = res[i] == 13;
-		}
-	}
-}
-
-
-void LoadFromFile(HWND hwnd, std::ifstream & file)
-{
-char buf[64];
-std::streamsize size;
-
-	res.clear();
-
-	do
-	{
-		file.read(buf, sizeof(buf)-1);
-
-		size = file.gcount();
-		buf[size] = 0;
-		res += buf;
-	}
-	while( !file.eof() );
-
-	CorrectUnixMode();
-	SetWindowText(edit, res.c_str());
-}
-
-
-
-
 LRESULT PadOpen(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 {
 	if( !OpenDialog(hwnd) )
 		return 0;
 
-
-	std::ifstream file(file_name.c_str(), std::ios_base::in | std::ios_base::binary);
+	TextFile file;
 	Languages * lang = GetPrgRes()->GetLanguages();
 
-	if( !file )
+	if( !file.Open(file_name.c_str()) )
 	{
 		MessageBox(hwnd, lang->GuiMessage(Languages::cannot_open_file),
 						 lang->GuiMessage(Languages::message_box_error_caption), MB_ICONERROR);
 		return 0;
 	}
 
-	file.seekg(0, std::ios::end);
-	std::ifstream::pos_type pos = file.tellg();
+	// new lines are changed into "\r\n" so the text can be longer than the file
+	bool too_long = file.Size() > max_text_size;
 
-	if( pos > 65530 )
+	if( !too_long )
 	{
+		file.Read(res, "\r\n");
+		too_long = res.size() > max_text_size;
+	}
+
+	file.Close();
+
+	if( too_long )
+	{
+		res.clear();
 		MessageBox(hwnd, lang->GuiMessage(Languages::file_too_long),
 						 lang->GuiMessage(Languages::message_box_error_caption), MB_ICONERROR);
 		return 0;
 	}
 
-	file.seekg(0);
-	LoadFromFile(hwnd, file);
-
-	file.close();
+	CancelJob();
+	SetWindowText(edit, res.c_str());
+	res.clear();
 
 return 0;
 }
@@ -695,6 +884,7 @@ return 0;
 
 LRESULT PadNew(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 {
+	CancelJob();
 	SetWindowText(edit, "");
 
 return 0;
@@ -750,6 +940,14 @@ return 0;
 }
 
 
+LRESULT PadRecalculate(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
+{
+	RecalculateDocument();
+
+return 0;
+}
+
+
 void PadInitMenuEdit(HMENU menu)
 {
 DWORD sel_start, sel_end;
@@ -808,6 +1006,7 @@ void CreatePadCommandTable(Messages<LRESULT> & messages)
 	messages.Associate(MENUPAD_EDIT_PASTE,  PadPaste);
 	messages.Associate(MENUPAD_EDIT_DEL,  PadDel);
 	messages.Associate(MENUPAD_EDIT_SELECTALL, PadSelectAll);
+	messages.Associate(MENUPAD_EDIT_RECALCULATE, PadRecalculate);
 }
 
 
@@ -840,6 +1039,7 @@ void CreatePadMessagesTable(Messages<LRESULT> & messages)
 	messages.Associate(WM_SETFOCUS, PadFocus);
 	messages.Associate(WM_COMMAND,  PadCommand);
 	messages.Associate(WM_INITMENUPOPUP, PadInitMenuPopUp);
+	messages.Associate(WM_PAD_FINISHED, PadFinished);
 }
 
 
@@ -928,6 +1128,7 @@ void DestroyPadWindow()
 {
 using namespace Pad;
 
+	CancelJob();
 	DeleteObject(font);
 }
 
@@ -0,0 +1,535 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*!
+	\file padrun.cpp
+    \brief the pad without the gui - a document is calculated and written with the results
+*/
+
+#include "compileconfig.h"
+#include "evaluator.h"
+#include "worksheet.h"
+#include "symboltable.h"
+#include "commandline.h"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <set>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+namespace PadRun
+{
+EvaluatorSettings settings;
+Languages languages;
+Worksheet worksheet;
+
+// variables and functions from the configuration file (they are not changed)
+ttmath::Objects variables;
+ttmath::Objects functions;
+SymbolTable symbols;
+
+// variables of the document with their last values (from the blocks calculated
+// so far) and names of variables whose last assignment failed
+ttmath::Objects assigned;
+std::set<std::string> failed;
+
+// only the variables and functions which can be used by the current block,
+// the ids are changed when the tables differ from the tables of the previous block
+ttmath::Objects block_variables;
+ttmath::Objects block_functions;
+int block_variables_id = 0;
+int block_functions_id = 0;
+
+bool statistics = true;
+bool enter      = false;
+const char * config_file = 0;
+const char * input_file  = "-";
+const char * output_file = 0;
+
+// zero means as many threads as processors (as in the pad)
+unsigned int threads = 0;
+
+// how many lines are calculated at once
+size_t block_lines = 4096;
+
+unsigned long lines  = 0;
+unsigned long errors = 0;
+
+std::string text, result;
+
+// "\r\n" if the first line of the document ends with it
+const char * new_line = 0;
+
+
+
+void PrintUsage()
+{
+	fprintf(stderr,
+		"usage: ttcalcpad [options] [input [output]]\n"
+		"the document is calculated as by the pad (F9) and written with the results\n"
+		"appended to the lines (\"line -> result\", more values are separated by\n"
+		"\"  ;  \"), annotations of a document which was calculated before are replaced\n"
+		"so the written document can be calculated again, the document is read from\n"
+		"the input file (or from stdin if there is no file or it is '-') and written\n"
+		"to the output file (or to stdout)\n\n"
+		"  -b lines       how many lines are calculated at once (default: 4096),\n"
+		"                 variables of the document assigned in the previous blocks\n"
+		"                 are passed by their values\n"
+		"  -c file        read variables and functions from a ttcalc.ini file\n"
+		"  -enter         write the results as the pad puts them when enter is pressed:\n"
+		"                 each value in its own line below the line and a space after\n"
+		"                 the last one, nothing for errors (such a document cannot be\n"
+		"                 calculated again, the results would be taken as expressions)\n"
+		"  -q             don't print statistics on stderr\n"
+		"  -t threads     how many threads calculate a block (0 - as many as processors,\n"
+		"                 default: 0)\n");
+
+	CommandLine::PrintSettingsOptions(stderr);
+}
+
+
+void Init()
+{
+	languages.InitAll();
+	languages.SetCurrentLanguage(Languages::en);
+
+	if( threads == 0 )
+		threads = HowManyProcessors();
+
+	worksheet.SetThreads(threads);
+
+	// the configuration file is given to the symbol table only once
+	symbols.Build(&variables, &functions);
+}
+
+
+/*!
+	the same characters as ttmath accepts in names
+*/
+bool IsNameCharacter(char c)
+{
+	return (c>='a' && c<='z') || (c>='A' && c<='Z') || c=='_' || (c>='0' && c<='9');
+}
+
+
+/*!
+	name-like parts of a string
+*/
+void AddNames(const char * str, std::set<std::string> & names)
+{
+	while( *str )
+	{
+		if( !IsNameCharacter(*str) )
+		{
+			++str;
+			continue;
+		}
+
+		const char * start = str;
+
+		while( IsNameCharacter(*str) )
+			++str;
+
+		names.insert(std::string(start, str));
+	}
+}
+
+
+bool Same(const ttmath::Objects & objects1, const ttmath::Objects & objects2)
+{
+ttmath::Objects::CIterator i1 = objects1.Begin();
+ttmath::Objects::CIterator i2 = objects2.Begin();
+
+	for( ; i1 != objects1.End() && i2 != objects2.End() ; ++i1, ++i2)
+		if( i1->first != i2->first || i1->second.value != i2->second.value ||
+			i1->second.param != i2->second.param )
+			return false;
+
+return i1 == objects1.End() && i2 == objects2.End();
+}
+
+
+/*!
+	the block gets only the variables and functions which its lines can use:
+	objects from the configuration file selected by the symbol table and variables
+	of the document whose names are in the lines or in the selected objects (they
+	hide variables from the configuration file of the same names)
+
+	a variable whose last assignment failed is not given at all, the lines using it
+	get "unknown variable" as in the pad where the whole document is calculated at once
+
+	the tables are small (the size of the document and of the configuration file
+	doesn't matter) and their ids are changed only if they differ from the tables
+	of the previous block, the worksheet builds its symbol table only then
+*/
+void SelectObjects()
+{
+ttmath::Objects new_variables, new_functions;
+ttmath::Objects::CIterator i;
+std::set<std::string> names;
+std::set<std::string>::iterator n;
+std::string value;
+
+	symbols.Select(text.c_str(), new_variables, new_functions);
+	AddNames(text.c_str(), names);
+
+	for(i = new_variables.Begin() ; i != new_variables.End() ; ++i)
+		AddNames(i->second.value.c_str(), names);
+
+	for(i = new_functions.Begin() ; i != new_functions.End() ; ++i)
+		AddNames(i->second.value.c_str(), names);
+
+	for(n = names.begin() ; n != names.end() ; ++n)
+	{
+		if( failed.find(*n) != failed.end() )
+		{
+			new_variables.Delete(*n);
+		}
+		else
+		if( assigned.GetValue(*n, value) == ttmath::err_ok )
+		{
+			if( new_variables.IsDefined(*n) )
+				new_variables.EditValue(*n, value);
+			else
+				new_variables.Add(*n, value);
+		}
+	}
+
+	if( !Same(new_variables, block_variables) )
+	{
+		block_variables = new_variables;
+		++block_variables_id;
+	}
+
+	if( !Same(new_functions, block_functions) )
+	{
+		block_functions = new_functions;
+		++block_functions_id;
+	}
+}
+
+
+/*!
+	the variables assigned by the block are given to the next blocks
+	(only the last value of a variable is remembered)
+*/
+void PassAssignments()
+{
+	for(size_t i=0 ; i<worksheet.Size() ; ++i)
+	{
+		const Worksheet::Line & line = worksheet.GetLine(i);
+
+		if( line.code != ttmath::err_ok )
+			++errors;
+
+		if( line.name.empty() )
+			continue;
+
+		if( line.code == ttmath::err_ok )
+		{
+			failed.erase(line.name);
+
+			if( assigned.IsDefined(line.name) )
+				assigned.EditValue(line.name, line.value);
+			else
+				assigned.Add(line.name, line.value);
+		}
+		else
+		{
+			assigned.Delete(line.name);
+			failed.insert(line.name);
+		}
+	}
+}
+
+
+/*!
+	the results are written as the pad puts them when enter is pressed
+	(PutResultFromParser() before): below the line, each value in its own line
+	and a space after the last one, nothing is written for an error
+	(only for an overflow when printing the result)
+*/
+void WriteEnter(std::ostream & out)
+{
+	for(size_t i=0 ; i<worksheet.Size() ; ++i)
+	{
+		const Worksheet::Line & line = worksheet.GetLine(i);
+
+		out << line.text << new_line;
+
+		if( line.calculated || line.code == ttmath::err_overflow )
+			out << line.result << ' ' << new_line;
+	}
+}
+
+
+/*!
+	the lines in 'text' are calculated and written,
+	the block is forgotten after that
+*/
+void EvaluateBlock(std::ostream & out)
+{
+	SelectObjects();
+
+	worksheet.SetSeparator(enter ? new_line : "  ;  ");
+	worksheet.SetObjectsId(block_variables_id, block_functions_id);
+	worksheet.SetText(text);
+	worksheet.Run(settings, block_variables, block_functions, &languages);
+
+	if( enter )
+	{
+		WriteEnter(out);
+	}
+	else
+	{
+		worksheet.Annotate(result, new_line);
+		out.write(result.c_str(), result.size());
+		out << new_line;
+	}
+
+	lines += (unsigned long)worksheet.Size();
+	PassAssignments();
+	worksheet.Clear();
+}
+
+
+/*!
+	only one block of lines is kept in memory at a time
+*/
+void EvaluateStream(std::istream & in, std::ostream & out)
+{
+std::string line;
+size_t size = 0;
+
+	while( std::getline(in, line) )
+	{
+		if( !new_line )
+			new_line = (!line.empty() && line[line.size()-1] == '\r') ? "\r\n" : "\n";
+
+		if( size > 0 )
+			text += '\n';
+
+		text += line;
+
+		if( ++size == block_lines )
+		{
+			EvaluateBlock(out);
+			text.clear();
+			size = 0;
+		}
+	}
+
+	if( size > 0 )
+		EvaluateBlock(out);
+}
+
+
+bool EvaluateFile(std::ostream & out)
+{
+	if( strcmp(input_file, "-") == 0 )
+	{
+		EvaluateStream(std::cin, out);
+		return true;
+	}
+
+	std::ifstream file(input_file, std::ios_base::in | std::ios_base::binary);
+
+	if( !file )
+	{
+		fprintf(stderr, "ttcalcpad: I cannot open: %s\n", input_file);
+		return false;
+	}
+
+	EvaluateStream(file, out);
+
+return true;
+}
+
+
+/*!
+	returning false if the program should finish
+*/
+bool ReadArguments(int argc, char ** argv)
+{
+bool error;
+int files = 0;
+
+	for(int i=1 ; i<argc ; ++i)
+	{
+		if( CommandLine::ReadSettingsOption(argc, argv, i, settings, error) )
+		{
+			if( error )
+			{
+				fprintf(stderr, "ttcalcpad: a value for %s is missing\n", argv[i]);
+				return false;
+			}
+		}
+		else
+		if( strcmp(argv[i], "-b") == 0 && i+1<argc )
+		{
+			block_lines = strtoul(argv[++i], 0, 10);
+
+			if( block_lines == 0 )
+				block_lines = 1;
+		}
+		else
+		if( strcmp(argv[i], "-c") == 0 && i+1<argc )
+		{
+			config_file = argv[++i];
+		}
+		else
+		if( strcmp(argv[i], "-enter") == 0 )
+		{
+			enter = true;
+		}
+		else
+		if( strcmp(argv[i], "-q") == 0 )
+		{
+			statistics = false;
+		}
+		else
+		if( strcmp(argv[i], "-t") == 0 && i+1<argc )
+		{
+			threads = (unsigned int)atoi(argv[++i]);
+		}
+		else
+		if( (argv[i][0] == '-' && argv[i][1] != 0) || files == 2 )
+		{
+			PrintUsage();
+			return false;
+		}
+		else
+		{
+			if( files++ == 0 )
+				input_file = argv[i];
+			else
+				output_file = argv[i];
+		}
+	}
+
+return true;
+}
+
+
+bool ReadConfig()
+{
+	if( !config_file )
+		return true;
+
+	int bad_line = -1;
+	IniParser::Error err = CommandLine::ReadVariablesFunctions(config_file, variables, functions, &bad_line);
+
+	if( err == IniParser::err_cant_open_file )
+	{
+		fprintf(stderr, "ttcalcpad: I cannot open: %s\n", config_file);
+		return false;
+	}
+
+	if( err != IniParser::err_ok )
+		fprintf(stderr, "ttcalcpad: %s: syntax error in line %d\n", config_file, bad_line);
+
+return true;
+}
+
+
+void PrintStatistics(double time)
+{
+	if( !statistics )
+		return;
+
+	fprintf(stderr, "ttcalcpad: %lu lines (%lu errors) in %.3f s", lines, errors, time);
+
+	if( time > 0.0 )
+		fprintf(stderr, ", %.0f lines/s", double(lines) / time);
+
+	fprintf(stderr, "\n");
+}
+
+
+} // namespace PadRun
+
+
+
+int main(int argc, char ** argv)
+{
+using namespace PadRun;
+
+std::ofstream file;
+std::ostream * out = &std::cout;
+
+	if( !ReadArguments(argc, argv) )
+		return 2;
+
+	if( !ReadConfig() )
+		return 2;
+
+	if( output_file )
+	{
+		file.open(output_file, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+
+		if( !file )
+		{
+			fprintf(stderr, "ttcalcpad: I cannot create: %s\n", output_file);
+			return 2;
+		}
+
+		out = &file;
+	}
+
+	std::ios_base::sync_with_stdio(false);
+	Init();
+
+	double start = CommandLine::GetTime();
+	bool opened  = EvaluateFile(*out);
+
+	out->flush();
+
+	if( !*out )
+	{
+		fprintf(stderr, "ttcalcpad: I cannot write the document\n");
+		return 1;
+	}
+
+	PrintStatistics(CommandLine::GetTime() - start);
+
+return opened ? 0 : 1;
+}
@@ -42,11 +42,16 @@
 
 
 
-ParserManager::ParserManager() : buffer_len(20480)
+ParserManager::ParserManager() : buffer_len(ThreadController::input_size)
 {
 	buffer = 0;
 	last_variables_id = 0;
 	last_functions_id = 0;
+	symbols_changed = true;
+	selected = false;
+	changed = true;
+	progressive = true;
+	code = ttmath::err_ok;
 }
 
 
@@ -80,147 +85,162 @@ ttmath::ErrorCode ParserManager::GetLastCode()
 
 ttmath::ErrorCode ParserManager::Parse()
 {
-	try
+	// only settings of displaying have changed - the last values are printed again
+	if( !changed && evaluator.Reprint(settings) )
 	{
-	#ifndef TTCALC_PORTABLE
+		code = evaluator.GetLastCode();
+	}
+	else
+	{
+		SelectObjects();
+		code    = evaluator.Parse(buffer, settings);
+		changed = false;
+	}
 
-		switch( precision )
-		{
-		case 0:
-			Parse(parser1);
-			break;
+	// printing doesn't need variables and functions, if we don't hold them
+	// the gui can change them without copying
+	ReleaseVariables();
 
-		case 1:
-			Parse(parser2);
-			break;
+return code;
+}
 
-		default:
-			Parse(parser3);
-			break;
-		}
 
-	#else
+bool ParserManager::ParseProvisional()
+{
+	if( !progressive || settings.precision == ttmath_level_small )
+		return false;
 
-		Parse(parser1);
+	if( !changed && evaluator.CanReprint(settings) )
+		return false;
 
-	#endif
-	}
-	catch(...)
-	{
-		// we are in a thread, we shouldn't go up
-		code = ttmath::err_internal_error;
-	}
+	if( evaluator.IsCached(buffer, settings) )
+		return false;
 
-return code;
+	EvaluatorSettings provisional_settings(settings);
+	provisional_settings.precision = ttmath_level_small;
+
+	// 'changed' is not cleared - the values are not the ones for the current settings
+	SelectObjects();
+	code = evaluator.Parse(buffer, provisional_settings);
+
+return code == ttmath::err_ok && evaluator.Calculated();
 }
 
 
 void ParserManager::MakeCopyOfVariables()
 {
-unsigned int i;
-
-	char * pchar = (char*)GetPrgRes()->GetBuffer();
-	for(i = 0 ; i<buffer_len-1 && pchar[i]!=0 ; ++i)
-		buffer[i] = pchar[i];
-
-	buffer[i] = 0;
+	// if the input has not changed we calculate the old one again
+	// (e.g. the precision was changed)
+	if( GetPrgRes()->GetThreadController()->TakeInput(buffer) )
+		changed = true;
 
-	//
-	
 	if( GetPrgRes()->GetVariablesId() != last_variables_id )
 	{
-		variables = *GetPrgRes()->GetVariables();
 		last_variables_id = GetPrgRes()->GetVariablesId();
+		symbols_changed = true;
+		changed = true;
 	}
 
 	if( GetPrgRes()->GetFunctionsId() != last_functions_id )
 	{
-		functions = *GetPrgRes()->GetFunctions();
 		last_functions_id = GetPrgRes()->GetFunctionsId();
+		symbols_changed = true;
+		changed = true;
 	}
 
+	// only reference counters are incremented here,
+	// the symbol table is rebuilt later in SelectObjects() (the gui is not blocked then)
+	variables = GetPrgRes()->GetVariablesSnapshot();
+	functions = GetPrgRes()->GetFunctionsSnapshot();
+	selected  = false;
 
-	base_input         = GetPrgRes()->GetBaseInput();
-	base_output        = GetPrgRes()->GetBaseOutput();
-	always_scientific  = GetPrgRes()->GetDisplayAlwaysScientific();
-	when_scientific    = GetPrgRes()->GetDisplayWhenScientific();
-	rounding           = GetPrgRes()->GetDisplayRounding();
-	precision          = GetPrgRes()->GetPrecision();
-	remove_zeroes      = GetPrgRes()->GetRemovingZeroes();
-	angle_deg_rad_grad = GetPrgRes()->GetDegRadGrad();
-	country            = GetPrgRes()->GetLanguages()->GetCurrentLanguage();
-	decimal_point      = GetPrgRes()->GetDecimalPointChar();
-	grouping           = GetPrgRes()->GetGroupingChar();
-	grouping_digits    = GetPrgRes()->GetGroupingDigits();
-	param_sep          = GetPrgRes()->GetParamSepChar();
-
-	GetPrgRes()->GetInputDecimalPointChar(&input_comma1, &input_comma2);
-
-	conv_type = GetPrgRes()->GetConvert()->GetCurrentType();
-	GetPrgRes()->GetConvert()->GetCurrentUnit(conv_type, conv_input_unit, conv_output_unit);
+	evaluator.SetObjectsId(last_variables_id, last_functions_id);
+	GetPrgRes()->GetEvaluatorSettings(settings);
+	progressive = GetPrgRes()->GetProgressive();
 }
 
 
-void ParserManager::Init()
+void ParserManager::ReleaseVariables()
 {
-	buffer = new char[buffer_len];
-	buffer[0] = 0;
+	variables.Reset();
+	functions.Reset();
+}
 
-	parser1.SetStopObject( GetPrgRes()->GetThreadController()->GetStopObject() );
-	parser1.SetVariables( &variables );
-	parser1.SetFunctions( &functions );
 
-	#ifndef TTCALC_PORTABLE
+/*!
+	the parser gets only the variables and functions which the input can use
+	(the result is the same but the parser searches small tables)
+*/
+void ParserManager::SelectObjects()
+{
+	if( selected )
+		return;
+
+	if( symbols_changed )
+	{
+		symbols.Build(variables.Get(), functions.Get());
+		symbols_changed = false;
+	}
 
-	parser2.SetStopObject( GetPrgRes()->GetThreadController()->GetStopObject() );
-	parser2.SetVariables( &variables );
-	parser2.SetFunctions( &functions );
+	symbols.Select(buffer, used_variables, used_functions);
+	selected = true;
+}
+
+
+void ParserManager::Init()
+{
+	buffer = new char[buffer_len];
+	buffer[0] = 0;
 
-	parser3.SetStopObject( GetPrgRes()->GetThreadController()->GetStopObject() );
-	parser3.SetVariables( &variables );
-	parser3.SetFunctions( &functions );
+	evaluator.SetStopObject( GetPrgRes()->GetThreadController()->GetStopObject() );
+	evaluator.SetVariables( &used_variables );
+	evaluator.SetFunctions( &used_functions );
+	evaluator.SetLanguages( GetPrgRes()->GetLanguages() );
 
+	#ifdef TTCALC_CONVERT
+	evaluator.SetConvert( GetPrgRes()->GetConvert() );
 	#endif
 }
 
 
-int ParserManager::PrintResult()
+// 1 if carry
+int ParserManager::PrintResult(std::string & output)
 {
-	if( code == ttmath::err_ok )
-	{
-	#ifndef TTCALC_PORTABLE
+size_t i, len;
 
-		switch( precision )
-		{
-		case 0:
-			return PrintResult(parser1);
+	output.erase();
 
-		case 1:
-			return PrintResult(parser2);
+	if( code != ttmath::err_ok )
+		return 0;
 
-		default:
-			return PrintResult(parser3);
+	len = evaluator.ResultSize();
+
+	for(i=0 ; i<len ; ++i)
+	{
+		if( evaluator.PrintValue(i, buffer2) )
+		{
+			code = ttmath::err_overflow;
+			output.erase();
+			return 1;
 		}
 
-	#else
-		return PrintResult(parser1);
-	#endif
+		output += buffer2;
+		AddOutputSuffix(output);
+
+		if( i < len-1 )
+			output += "  ;  ";
 	}
 
 return 0;
 }	
 
 
-void ParserManager::ShowConvertingInfo()
+void ParserManager::PrintConvertingInfo(std::string & info)
 {
-HWND conv_tab = GetPrgRes()->GetTabWindow(TabWindowFunctions::tab_convert);
+	info.erase();
 
-	if( conv_type==0 || conv_input_unit==-1 || conv_output_unit==-1 ||
-		conv_input_unit == conv_output_unit )
-	{
-		SetDlgItemText(conv_tab, IDC_EDIT_OUTPUT_INFO, "");
+	if( !settings.CanWeConvert() )
 		return;
-	}
 
 	Convert * pconv = GetPrgRes()->GetConvert();
 
@@ -228,42 +248,40 @@ HWND conv_tab = GetPrgRes()->GetTabWindow(TabWindowFunctions::tab_convert);
 
 	ttmath::Big<1,1> result;
 	result.SetOne();
-	std::string buffer1 = "1 ";
-	buffer1 += pconv->GetUnitAbbr(country, conv_input_unit);
-	buffer1 += " = ";
+	info = "1 ";
+	info += pconv->GetUnitAbbr(settings.country, settings.conv_input_unit);
+	info += " = ";
 
-	if(	pconv->Conversion(conv_input_unit, conv_output_unit, result) )
+	if(	pconv->Conversion(settings.conv_input_unit, settings.conv_output_unit, result) )
 	{
-		SetDlgItemText(conv_tab, IDC_EDIT_OUTPUT_INFO, "overflow" );
+		info = "overflow";
 		return;
 	}
 
 	result.ToString(buffer2, 10, false, 3, -1, true);
 
-	buffer1 += buffer2;
-	buffer1 += " "; 
-	buffer1 += pconv->GetUnitAbbr(country, conv_output_unit);
+	info += buffer2;
+	info += " "; 
+	info += pconv->GetUnitAbbr(settings.country, settings.conv_output_unit);
 
 
 	// the second unit to the first
 
-	buffer1 += "   1 ";
-	buffer1 += pconv->GetUnitAbbr(country, conv_output_unit);
-	buffer1 += " = ";
+	info += "   1 ";
+	info += pconv->GetUnitAbbr(settings.country, settings.conv_output_unit);
+	info += " = ";
 	
 	result.SetOne();
-	if(	pconv->Conversion(conv_output_unit, conv_input_unit, result) )
+	if(	pconv->Conversion(settings.conv_output_unit, settings.conv_input_unit, result) )
 	{
-		SetDlgItemText(conv_tab, IDC_EDIT_OUTPUT_INFO, "overflow" );
+		info = "overflow";
 		return;
 	}
 
 	
 	result.ToString(buffer2, 10, false, 3, -1, true);
 
-	buffer1 += buffer2;
-	buffer1 += " "; 
-	buffer1 += pconv->GetUnitAbbr(country, conv_input_unit);
-	
-	SetDlgItemText(conv_tab, IDC_EDIT_OUTPUT_INFO, buffer1.c_str() );
+	info += buffer2;
+	info += " "; 
+	info += pconv->GetUnitAbbr(settings.country, settings.conv_input_unit);
 }
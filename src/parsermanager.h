@@ -45,16 +45,20 @@
 
 #include "resource.h"
 #include "programresources.h"
+#include "symboltable.h"
 #include <windows.h>
 
 
 /*!
 	\brief object of type ParserManager we're using during calculating
 
-	In our program we're using three kind of precisions. First is the smallest
-	, and the third is the biggest. Because precision is established during
-	compilation (templates) we need three different objects. ParserManager
-	helps us to maintain these objects.
+	In our program we're using three kind of precisions (small, medium and big),
+	they are levels of the precision ladder from bigtypes.h. Because precision
+	is established during compilation (templates) we need a different object for
+	each level. Those objects are kept by the Evaluator (the evaluation core without
+	the win32 api),
+	ParserManager copies the state of the program into the evaluator
+	and prints its results on the main window.
 */
 class ParserManager
 {
@@ -68,8 +72,25 @@ public:
 
 	/*!
 		the main method which call parserX.Parse(...)
+
+		if the input string, variables and functions are the same as before
+		and only settings of displaying have changed then nothing is parsed
+		(the last values will be printed with the new settings)
 	*/
 	ttmath::ErrorCode Parse();
+
+
+	/*!
+		the progressive mode: the input is calculated with the small precision
+		(ttmath_level_small) so we can show something before Parse() has finished
+
+		it returns true if there is a result to print, false when the progressive
+		mode is off, the precision is already the smallest one or Parse() would
+		give the result at once (the values can be printed again or are in the cache)
+
+		Parse() has to be called afterwards, it calculates with the proper precision
+	*/
+	bool ParseProvisional();
 	
 
 	/*
@@ -83,11 +104,23 @@ public:
 		WaitForCalculatingAndBlockForStop() method from the ThreadController
 
 		only in this method we can read variables which can be changed
-		by the first thread
+		by the first thread, the input string is taken from the mailbox
+		of the ThreadController (our buffer is swapped with the mailbox)
+
+		variables and functions are not copied, we take snapshots of them
+		(they are shared with the first thread until it changes them)
 	*/
 	void MakeCopyOfVariables();
 
 
+	/*!
+		releasing the snapshots of variables and functions
+		(Parse() calls it when it has finished, the calculation thread
+		when it skips the job)
+	*/
+	void ReleaseVariables();
+
+
 	/*!
 		it prepares our three parsers to work, it should be called only once
 	*/
@@ -95,158 +128,70 @@ public:
 
 
 	/*!
-		this method prints result
-		(a correct value if was or an error instead)
+		this method prints result into 'output'
+		(output is empty if there was an error, the gui prints the error then)
+
+		it returns 1 if there was a carry during converting
 	*/
-	int PrintResult();
+	int PrintResult(std::string & output);
 
 
 	/*!
-		this method prints the info about converting (on the converting tab)
+		this method prints the info about converting (shown on the converting tab)
 	*/
-	void ShowConvertingInfo();
+	void PrintConvertingInfo(std::string & info);
 
 
 private:
 
-#ifndef TTCALC_PORTABLE
-	ttmath::Parser<TTMathBig1> parser1;
-	ttmath::Parser<TTMathBig2> parser2;
-	ttmath::Parser<TTMathBig3> parser3;
-#else
-	ttmath::Parser<TTMathBig1> parser1;
-#endif
+	Evaluator evaluator;
+	EvaluatorSettings settings;
 
-	ttmath::Objects variables, functions;
+	ObjectsSnapshot variables, functions;
 	int last_variables_id;
 	int last_functions_id;
 
-	const unsigned int buffer_len;
-	char * buffer;
+	// the hashed names of variables and functions (rebuilt when they have changed)
+	// and only those objects which are used by the current input
+	SymbolTable symbols;
+	ttmath::Objects used_variables, used_functions;
+	bool symbols_changed;
+	bool selected;
 
-	int base_input, base_output;
-	int conv_type, conv_input_unit, conv_output_unit;
+	// true if the input, variables or functions have changed since the last parsing
+	// (a job can be discarded after it has taken a new input)
+	bool changed;
 
-	bool always_scientific;
-	int when_scientific;
-	int rounding;
-	bool remove_zeroes;
-	int precision;
-	Languages::Country country;
-	ttmath::ErrorCode code;
-	int angle_deg_rad_grad;
+	// a copy of the progressive mode flag from ProgramResources
+	bool progressive;
 
-	char decimal_point;
-	char grouping;
-	char input_comma1;
-	char input_comma2;
-	char param_sep;
+	const unsigned int buffer_len;
+	char * buffer;
 
-	int grouping_digits;
+	ttmath::ErrorCode code;
 
 	/*
-		some buffers which we use in some method in the second thread,
-		it's better to have those buffers outside those methods -
-		if the buffers were in the methods there would be still allocating
+		a buffer which we use in some method in the second thread,
+		it's better to have this buffer outside those methods -
+		if the buffer was in the methods there would be still allocating
 		and deallocating memory
 	*/
-	std::string buffer1, buffer2;
+	std::string buffer2;
 	
 
-	bool CanWeConvert() const
-	{
-		if( conv_type != 0 )
-			if( conv_input_unit!=-1 && conv_output_unit!=-1 &&
-				conv_input_unit!=conv_output_unit )
-				return true;
-
-	return false;
-	}
-
+	void SelectObjects();
 
 
 	void AddOutputSuffix(std::string & result)
 	{
-		if( CanWeConvert() )
+		if( settings.CanWeConvert() )
 		{
 			result += " ";
-			result += GetPrgRes()->GetConvert()->GetUnitAbbr(country, conv_output_unit);
+			result += GetPrgRes()->GetConvert()->GetUnitAbbr(settings.country, settings.conv_output_unit);
 		}
 	}
 
 
-	// 1 if carry
-	template<class ValueType>
-	int PrintResult(ttmath::Parser<ValueType> & matparser)
-	{
-	unsigned int i = 0;
-
-		buffer1.erase();
-		buffer2.erase();
-
-		for(i=0 ; i<matparser.stack.size() ; ++i)
-		{
-			try
-			{
-				ValueType result = matparser.stack[i].value;
-				
-				if( CanWeConvert() )
-				{
-					if( GetPrgRes()->GetConvert()->Conversion(conv_input_unit, conv_output_unit, result) )
-					{
-						code = ttmath::err_overflow;
-						return 1;
-					}
-				}
-
-				ttmath::Conv conv;
-
-				conv.base         = base_output;
-				conv.scient       = always_scientific;
-				conv.scient_from  = when_scientific;
-				conv.round        = rounding;
-				conv.trim_zeroes  = remove_zeroes;
-				conv.comma        = decimal_point;
-				conv.group        = grouping;
-				conv.group_digits = grouping_digits;
-
-				if( result.ToString(buffer2, conv) )
-				{
-					// we shouldn't have had this error in the new version of ToStrign(...)
-					// (where we're using a bigger type for calculating)
-					buffer2 = GetPrgRes()->GetLanguages()->GuiMessage(country, Languages::overflow_during_printing);
-				}
-			}
-			catch(...)
-			{
-				buffer2 = GetPrgRes()->GetLanguages()->ErrorMessage(country, ttmath::err_internal_error);
-			}
-
-			buffer1 += buffer2;
-			AddOutputSuffix(buffer1);
-
-			if( i < matparser.stack.size()-1 )
-				buffer1 += "  ;  ";
-		}
-
-		SetDlgItemText(GetPrgRes()->GetMainWindow(),IDC_OUTPUT_EDIT,buffer1.c_str());
-
-	return 0;
-	}
-
-	template<class ValueType>
-	void Parse(ttmath::Parser<ValueType> & matparser)
-	{
-		matparser.SetBase(base_input);
-		matparser.SetDegRadGrad(angle_deg_rad_grad);
-		matparser.SetComma(input_comma1, input_comma2);
-		matparser.SetGroup(grouping);
-		matparser.SetParamSep(param_sep);
-		code = matparser.Parse(buffer);
-	}
-
-
-
 };
 
 
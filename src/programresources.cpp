@@ -284,6 +284,28 @@ bool ProgramResources::GetRemovingZeroes()
 }
 
 
+void ProgramResources::SetProgressive(bool p)
+{
+	progressive = p;
+}
+
+bool ProgramResources::GetProgressive()
+{
+	return progressive;
+}
+
+
+void ProgramResources::SetFastPath(bool f)
+{
+	fast_path = f;
+}
+
+bool ProgramResources::GetFastPath()
+{
+	return fast_path;
+}
+
+
 void ProgramResources::SetDegRadGrad(int angle)
 {
 	if( angle < 0 || angle > 2 )
@@ -456,12 +478,24 @@ return c;
 
 ttmath::Objects * ProgramResources::GetVariables()
 {
-	return &variables;
+	return variables.Change();
 }
 
 ttmath::Objects * ProgramResources::GetFunctions()
 {
-	return &functions;
+	return functions.Change();
+}
+
+
+ObjectsSnapshot ProgramResources::GetVariablesSnapshot()
+{
+	return variables;
+}
+
+
+ObjectsSnapshot ProgramResources::GetFunctionsSnapshot()
+{
+	return functions;
 }
 
 
@@ -582,6 +616,11 @@ volatile ThreadController * ProgramResources::GetThreadController()
 	return &thread_controller;
 }
 
+ResultQueue * ProgramResources::GetResultQueue()
+{
+	return &result_queue;
+}
+
 void ProgramResources::SetPrecision(int p)
 {
 	if( p < 0 )
@@ -696,6 +735,30 @@ time_t ProgramResources::GetLastUpdate()
 }
 
 
+void ProgramResources::GetEvaluatorSettings(EvaluatorSettings & settings)
+{
+	settings.base_input         = GetBaseInput();
+	settings.base_output        = GetBaseOutput();
+	settings.always_scientific  = GetDisplayAlwaysScientific();
+	settings.when_scientific    = GetDisplayWhenScientific();
+	settings.rounding           = GetDisplayRounding();
+	settings.precision          = TTMathPrecisionLevel(GetPrecision());
+	settings.remove_zeroes      = GetRemovingZeroes();
+	settings.fast_path          = GetFastPath();
+	settings.angle_deg_rad_grad = GetDegRadGrad();
+	settings.country            = languages.GetCurrentLanguage();
+	settings.decimal_point      = GetDecimalPointChar();
+	settings.grouping           = GetGroupingChar();
+	settings.grouping_digits    = GetGroupingDigits();
+	settings.param_sep          = GetParamSepChar();
+
+	GetInputDecimalPointChar(&settings.input_comma1, &settings.input_comma2);
+
+	settings.conv_type = convert.GetCurrentType();
+	convert.GetCurrentUnit(settings.conv_type, settings.conv_input_unit, settings.conv_output_unit);
+}
+
+
 
 ProgramResources::ProgramResources()
 {
@@ -728,6 +791,8 @@ ProgramResources::ProgramResources()
 	display_when_scientific   = 8;
 	display_rounding          = -1;
 	remove_zeroes             = true;
+	progressive               = true;
+	fast_path                 = false;
 
 	for(int i=HowManyTabWindows()-1 ; i!=-1 ; --i)
 		tab_window[i] = 0;
@@ -939,6 +1004,7 @@ static const char help_name[] = "ttcalc.chm";
 void ProgramResources::SetConfigName()
 {
 	configuration_file = "ttcalc.ini";
+	journal.SetFileName(configuration_file);
 }
 
 
@@ -1029,19 +1095,21 @@ void ProgramResources::AddVariablesFunctions( IniParser::Section & temp_variable
 											  bool if_not_exist)
 {
 IniParser::Section::iterator ic;
+ttmath::Objects * pvariables = variables.Change();
+ttmath::Objects * pfunctions = functions.Change();
 
 	// we're adding variables
 
 	if( !if_not_exist )
 	{
-		variables.Clear();
+		pvariables->Clear();
 		VariablesChanged();
 	}
 
 	for( ic = temp_variables.begin() ; ic!=temp_variables.end() ; ++ic )
-		if( !if_not_exist || !variables.IsDefined(ic->first) )
+		if( !if_not_exist || !pvariables->IsDefined(ic->first) )
 		{
-			variables.Add(ic->first, ic->second);
+			pvariables->Add(ic->first, ic->second);
 			VariablesChanged();
 		}
 
@@ -1050,7 +1118,7 @@ IniParser::Section::iterator ic;
 
 	if( !if_not_exist )
 	{
-		functions.Clear();
+		pfunctions->Clear();
 		FunctionsChanged();
 	}
 
@@ -1059,10 +1127,10 @@ IniParser::Section::iterator ic;
 		const char * name;
 		int param;
 
-		if( !if_not_exist || !functions.IsDefined(ic->first) )
+		if( !if_not_exist || !pfunctions->IsDefined(ic->first) )
 			if( SplitFunction(ic->second, &name, &param) )
 			{
-				functions.Add(ic->first, name, param);
+				pfunctions->Add(ic->first, name, param);
 				FunctionsChanged();
 			}
 	}
@@ -1089,6 +1157,7 @@ IniParser::Section temp_variables, temp_functions;
 	if( err == IniParser::err_cant_open_file )
 		return err;
 
+	journal.Replay(temp_variables, temp_functions);
 	AddVariablesFunctions(temp_variables, temp_functions, true);
 
 	if( err != IniParser::err_ok )
@@ -1105,7 +1174,7 @@ IniParser::Error ProgramResources::ReadFromFile()
 IniParser iparser;
 IniParser::Section temp_variables, temp_functions;
 IniParser::Section::iterator ic;
-std::string ini_value[30];
+std::string ini_value[32];
 std::string language_setup;
 
 	iparser.ConvertValueToSmallLetters(false);
@@ -1144,11 +1213,14 @@ std::string language_setup;
 	iparser.Associate( "global|update.onstartup",		&ini_value[26] );
 	iparser.Associate( "global|update.last",			&ini_value[27] );
 	iparser.Associate( "global|disp.grouping.digits",	&ini_value[28] );
+	iparser.Associate( "global|progressive",			&ini_value[29] );
+	iparser.Associate( "global|fast.path",				&ini_value[30] );
 
 	iparser.Associate( "variables", &temp_variables );
 	iparser.Associate( "functions", &temp_functions );
 
 	bad_line = -1;
+	journal.SetFileName(configuration_file);
 	IniParser::Error err = iparser.ReadFromFile( configuration_file.c_str() );
 
 	if( err == IniParser::err_cant_open_file )
@@ -1157,6 +1229,8 @@ std::string language_setup;
 	if( err != IniParser::err_ok )
 		bad_line = iparser.GetBadLine();
 
+	// changes made after the file was written last time
+	journal.Replay(temp_variables, temp_functions);
 	AddVariablesFunctions(temp_variables, temp_functions, false);
 
 	// the first file is created by the installer and has only language.setup option
@@ -1237,15 +1311,28 @@ void ProgramResources::ReadGlobalSection(std::string * ini_value)
 
 	last_update = (time_t)atol(ini_value[27].c_str());
 	SetGroupingDigits( Int(ini_value[28]) );
+
+	// progressive mode - true by default (from the constructor)
+	if( !ini_value[29].empty() )
+		SetProgressive( Int(ini_value[29]) == 1 );
+
+	SetFastPath( Int(ini_value[30]) == 1 );
 }
 
 
 
 
 
+/*!
+	the whole file is written to a temporary file first and then it replaces
+	the configuration file (if the program is killed or the power fails during
+	writing the old file is left), the journal is not needed after that, the lines
+	are not flushed one by one - the file is flushed to the disk once after closing
+*/
 void ProgramResources::SaveToFile()
 {
-std::ofstream file( configuration_file.c_str() );
+std::string temp_file = configuration_file + ".tmp";
+std::ofstream file( temp_file.c_str() );
 
 	if( !file )
 		return;
@@ -1253,53 +1340,147 @@ std::ofstream file( configuration_file.c_str() );
 	file << "# the configuration file of the program ttcalc\n\n";
 	file << "[GLOBAL]\n";
 
-	file << "always.on.top = " << (int)always_on_top	<< std::endl;
-	file << "view          = " << (int)view				<< std::endl;
+	file << "always.on.top = " << (int)always_on_top	<< '\n';
+	file << "view          = " << (int)view				<< '\n';
 	file << "language      = " << (int)languages.GetCurrentLanguage()
-														<< std::endl;
-	file << "x             = " << x_pos					<< std::endl;
-	file << "y             = " << y_pos					<< std::endl;
-	file << "size.x        = " << x_size				<< std::endl;
-	file << "size.y        = " << y_size				<< std::endl;
-	file << "maximized     = " << (int)maximized		<< std::endl;
-	file << "update.onstartup  = " << (int)check_update_startup << std::endl;
-	file << "update.last   = " << (long)last_update << std::endl;
-	file << "pad           = " << (int)show_pad			<< std::endl;
-	file << "pad.x         = " << pad_x_pos				<< std::endl;
-	file << "pad.y         = " << pad_y_pos				<< std::endl;
-	file << "pad.size.x    = " << pad_x_size			<< std::endl;
-	file << "pad.size.y    = " << pad_y_size			<< std::endl;
-	file << "pad.maximized = " << (int)pad_maximized	<< std::endl;
-	file << "precision     = " << precision				<< std::endl;
-	file << "disp.input    = " << base_input			<< std::endl;
-	file << "disp.output   = " << base_output			<< std::endl;
-
-	file << "disp.alw.scientific  = " << (int)display_always_scientific	<< std::endl;
-	file << "disp.when.scientific = " << display_when_scientific		<< std::endl;
-	file << "disp.rounding        = " << display_rounding				<< std::endl;
-	file << "disp.remove.zeroes   = " << (int)remove_zeroes				<< std::endl;
-	file << "disp.input_comma     = " << input_decimal_point			<< std::endl;
-	file << "disp.output_comma    = " << decimal_point					<< std::endl;
-	file << "disp.deg_rad_grad    = " << angle_deg_rad_grad				<< std::endl;
-	file << "disp.grouping        = " << grouping						<< std::endl;
-	file << "disp.grouping.digits = " << grouping_digits				<< std::endl;
-	file << "disp.param_sep       = " << param_sep						<< std::endl;
-
-
-	file << "\n[variables]\n";
-
-	ttmath::Objects::CIterator iv = variables.Begin();
-
-	for( ; iv != variables.End() ; ++iv )
-		file << iv->first.c_str() << " = " << iv->second.value.c_str() << std::endl;
-
-	file << "\n[functions]\n";
-
-	iv = functions.Begin();
-	for( ; iv != functions.End() ; ++iv )
-		file << iv->first.c_str() << " = " << iv->second.param <<
-				" | " << iv->second.value.c_str() << std::endl;
+														<< '\n';
+	file << "x             = " << x_pos					<< '\n';
+	file << "y             = " << y_pos					<< '\n';
+	file << "size.x        = " << x_size				<< '\n';
+	file << "size.y        = " << y_size				<< '\n';
+	file << "maximized     = " << (int)maximized		<< '\n';
+	file << "update.onstartup  = " << (int)check_update_startup << '\n';
+	file << "update.last   = " << (long)last_update << '\n';
+	file << "pad           = " << (int)show_pad			<< '\n';
+	file << "pad.x         = " << pad_x_pos				<< '\n';
+	file << "pad.y         = " << pad_y_pos				<< '\n';
+	file << "pad.size.x    = " << pad_x_size			<< '\n';
+	file << "pad.size.y    = " << pad_y_size			<< '\n';
+	file << "pad.maximized = " << (int)pad_maximized	<< '\n';
+	file << "precision     = " << precision				<< '\n';
+	file << "progressive   = " << (int)progressive		<< '\n';
+	file << "fast.path     = " << (int)fast_path		<< '\n';
+	file << "disp.input    = " << base_input			<< '\n';
+	file << "disp.output   = " << base_output			<< '\n';
+
+	file << "disp.alw.scientific  = " << (int)display_always_scientific	<< '\n';
+	file << "disp.when.scientific = " << display_when_scientific		<< '\n';
+	file << "disp.rounding        = " << display_rounding				<< '\n';
+	file << "disp.remove.zeroes   = " << (int)remove_zeroes				<< '\n';
+	file << "disp.input_comma     = " << input_decimal_point			<< '\n';
+	file << "disp.output_comma    = " << decimal_point					<< '\n';
+	file << "disp.deg_rad_grad    = " << angle_deg_rad_grad				<< '\n';
+	file << "disp.grouping        = " << grouping						<< '\n';
+	file << "disp.grouping.digits = " << grouping_digits				<< '\n';
+	file << "disp.param_sep       = " << param_sep						<< '\n';
+
+
+	file << '\n';
+	WriteVariablesSection(file, *variables.Get());
+
+	file << '\n';
+	WriteFunctionsSection(file, *functions.Get());
+
+	file.close();
+
+	// the data must be on the disk before the file replaces the configuration file
+	// and the journal is removed
+	if( !file || !FlushFileToDisk(temp_file) )
+	{
+		remove(temp_file.c_str());
+		return;
+	}
+
+	if( ReplaceFileAtomically(temp_file, configuration_file) )
+		journal.Clear();
+	else
+		remove(temp_file.c_str());
+}
+
+
+/*!
+	only the change of one variable is appended to the journal,
+	if the variable is not defined now it has been deleted (or renamed)
+*/
+void ProgramResources::SaveVariableToFile(const std::string & name)
+{
+std::string value;
+bool saved;
+
+	if( !IsConfigurationFileWritten() )
+	{
+		SaveToFile();
+		return;
+	}
+
+	if( variables->GetValue(name, value) == ttmath::err_ok )
+		saved = journal.SetVariable(name, value);
+	else
+		saved = journal.DeleteVariable(name);
+
+	SaveJournal(saved);
+}
+
+
+/*!
+	only the change of one function is appended to the journal,
+	if the function is not defined now it has been deleted (or renamed)
+*/
+void ProgramResources::SaveFunctionToFile(const std::string & name)
+{
+std::string value;
+int param;
+bool saved;
+
+	if( !IsConfigurationFileWritten() )
+	{
+		SaveToFile();
+		return;
+	}
+
+	if( functions->GetValueAndParam(name, value, &param) == ttmath::err_ok )
+		saved = journal.SetFunction(name, value, param);
+	else
+		saved = journal.DeleteFunction(name);
+
+	SaveJournal(saved);
+}
+
+
+/*!
+	if the change could not be appended the whole file is written,
+	if the journal is too long the file is written too (with the changes
+	which other instances of the program have made in the meantime)
+*/
+void ProgramResources::SaveJournal(bool saved)
+{
+	if( !saved )
+	{
+		SaveToFile();
+	}
+	else
+	if( journal.IsFull() )
+	{
+		// the tables are changed so the second thread must not take
+		// their snapshots at the same time
+		thread_controller.StopCalculating();
+		ReadVariablesFunctionsFromFile();
+		thread_controller.StartCalculating();
+
+		SaveToFile();
+	}
+}
+
+
+/*!
+	the journal has only changes of the configuration file
+	so the file should exist
+*/
+bool ProgramResources::IsConfigurationFileWritten()
+{
+	std::ifstream file( configuration_file.c_str() );
 
+return file.is_open();
 }
 
 
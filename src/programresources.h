@@ -48,6 +48,9 @@
 #include "languages.h"
 #include "threadcontroller.h"
 #include "convert.h"
+#include "evaluator.h"
+#include "objectssnapshot.h"
+#include "configjournal.h"
 
 #include <ttmath/ttmathobjects.h>
 #include <string>
@@ -67,6 +70,10 @@
 #define WM_SET_LAST_ERROR		WM_APP+4
 #define WM_INIT_TAB_CONVERT		WM_APP+5
 #define WM_UPDATE_EXISTS		WM_APP+6
+#define WM_SET_RESULT			WM_APP+7
+#define WM_INIT_TAB_TABULATION	WM_APP+8
+#define WM_TABULATION_FINISHED	WM_APP+9
+#define WM_PAD_FINISHED			WM_APP+10
 
 
 /*!
@@ -87,8 +94,13 @@
 	you should call VariablesChanged() in order to inform the second thread that variables have changed
 	(variables_id will be increment), the same is for functions (FunctionsChanged() method)
 
+	the second thread doesn't copy the tables of variables and functions, it takes
+	a snapshot (GetVariablesSnapshot(), GetFunctionsSnapshot()) which only increments
+	a reference counter, GetVariables() and GetFunctions() copy the table only if such
+	a snapshot is still being used by someone
+
 	methods which are used by the second thread:
-		GetBuffer(), GetVariables(), GetFunctions(), GetBaseInput(), GetBaseOutput()
+		GetBuffer(), GetVariablesSnapshot(), GetFunctionsSnapshot(), GetBaseInput(), GetBaseOutput()
 		GetDisplayAlwaysScientific(), GetDisplayWhenScientific(), GetDisplayRounding()
 		GetCurrentLanguage(), GetPrecision() ...
 
@@ -261,6 +273,12 @@ public:
 	volatile ThreadController * GetThreadController();
 
 
+	/*!
+		results from the second thread (the second thread puts them and the gui takes them)
+	*/
+	ResultQueue * GetResultQueue();
+
+
 	/*!
 		if you change some variables by using GetVariable() method
 		you should call this method in order to inform the second thread that variables have changed
@@ -292,11 +310,28 @@ public:
 
 
 	/*!
-		pointers to variables' table, functions' table, the languages' object, convert object
-		and to the characters' buffer
+		pointers to variables' table and functions' table for changing them
+		(the table is copied first if a snapshot of it is still being used)
 	*/
 	ttmath::Objects * GetVariables();
 	ttmath::Objects * GetFunctions();
+
+
+	/*!
+		the current tables of variables and functions for reading,
+		they are shared (not copied) and stay unchanged as long as you hold them
+
+		the second thread calls them only in the special time of copying variables
+		(before ReadyForStop())
+	*/
+	ObjectsSnapshot GetVariablesSnapshot();
+	ObjectsSnapshot GetFunctionsSnapshot();
+
+
+	/*!
+		pointers to the languages' object, convert object
+		and to the characters' buffer
+	*/
 	Languages * GetLanguages();
 	Convert * GetConvert();
 	char * GetBuffer();
@@ -365,6 +400,14 @@ public:
 	IniParser::Error ReadFromFile();
 	void SaveToFile();
 
+	/*!
+		saving a change of one variable or function (after adding, editing or deleting),
+		the change is appended to the journal and the whole file is written
+		from time to time
+	*/
+	void SaveVariableToFile(const std::string & name);
+	void SaveFunctionToFile(const std::string & name);
+
 
 	/*!
 		it returns a number of a line where there was an error
@@ -381,6 +424,23 @@ public:
 	bool GetRemovingZeroes();
 
 
+	/*!
+		setting and returning the progressive mode: when a bigger precision is selected
+		the input is calculated with the smallest precision first and that result
+		is shown as provisional until the proper one is ready
+	*/
+	void SetProgressive(bool p);
+	bool GetProgressive();
+
+
+	/*!
+		setting and returning the fast path: simple arithmetic is calculated
+		on doubles when the printed digits can be proven (EvaluatorSettings::fast_path)
+	*/
+	void SetFastPath(bool f);
+	bool GetFastPath();
+
+
 	/*!
 		setting and returning the unit of angle in which sin/cos/tan/ctg (arc sin...) operate
 		0 - deg
@@ -496,6 +556,16 @@ public:
 	time_t GetLastUpdate();
 
 
+	/*!
+		copying the current settings of parsing and printing into 'settings'
+		(the snapshot used by the evaluation core)
+
+		the second thread calls it only in the special time of copying variables
+		(before ReadyForStop())
+	*/
+	void GetEvaluatorSettings(EvaluatorSettings & settings);
+
+
 private:
 
 	bool IsWhiteCharacter(int c);
@@ -508,12 +578,15 @@ private:
 	void ReadGlobalSection(std::string * ini_value);
 	int  Int(const std::string & text);
 	bool IsGlobalSectionSet(std::string * ini_value, size_t len);
+	void SaveJournal(bool saved);
+	bool IsConfigurationFileWritten();
 
-	ttmath::Objects variables;
-	ttmath::Objects functions;
+	ObjectsSnapshot variables;
+	ObjectsSnapshot functions;
 	Languages languages;
 	Convert convert;
 	volatile ThreadController thread_controller;
+	ResultQueue result_queue;
 
 	int variables_id;
 	int functions_id;
@@ -526,7 +599,7 @@ private:
 	HWND main_window;
 	HWND pad_window;
 	HWND pad_edit; // edit control on the pad window
-	HWND tab_window[6];
+	HWND tab_window[7];
 
 	int precision;
 	bool always_on_top;
@@ -534,6 +607,7 @@ private:
 	View view;
 
 	std::string configuration_file;
+	ConfigJournal journal;
 	std::string help_file;
 
 	int y_size_normal;
@@ -560,6 +634,8 @@ private:
 	int display_when_scientific;
 	int display_rounding;
 	bool remove_zeroes;
+	bool progressive;
+	bool fast_path;
 	int angle_deg_rad_grad;
 	int grouping;				// 0 - none, 1 - space, 2 - '`', 3 - '\'', 4 - '.', 5 - ','
 	int grouping_digits;        // from 1 to 9
@@ -60,6 +60,7 @@
 #define IDD_DIALOG_PRECISION			113
 #define IDD_DIALOG_DISPLAY				114
 #define IDD_DIALOG_CONVERT				115
+#define IDD_DIALOG_TABULATION			116
 
 #define IDR_MENU						200
 #define IDR_MENU2						201
@@ -202,6 +203,25 @@
 #define IDC_EDIT_OUTPUT_INFO					1208
 #define IDC_STATIC_UNIT_CONVERSION				1209
 
+// tabulation tab
+#define IDC_LABEL_TABULATION_VARIABLE			1220
+#define IDC_EDIT_TABULATION_VARIABLE			1221
+#define IDC_LABEL_TABULATION_START				1222
+#define IDC_EDIT_TABULATION_START				1223
+#define IDC_LABEL_TABULATION_STEP				1224
+#define IDC_EDIT_TABULATION_STEP				1225
+#define IDC_LABEL_TABULATION_COUNT				1226
+#define IDC_EDIT_TABULATION_COUNT				1227
+#define IDC_BUTTON_TABULATE						1228
+#define IDC_BUTTON_TABULATION_SAVE				1229
+#define IDC_EDIT_TABULATION_RESULT				1230
+
+// filters of the variables' and functions' lists
+#define IDC_LABEL_VARIABLES_FILTER				1240
+#define IDC_EDIT_VARIABLES_FILTER				1241
+#define IDC_LABEL_FUNCTIONS_FILTER				1242
+#define IDC_EDIT_FUNCTIONS_FILTER				1243
+
 
 // menu
 #define IDM_VIEW_INDEX					0
@@ -259,6 +279,7 @@
 #define MENUPAD_EDIT_PASTE				40513
 #define MENUPAD_EDIT_DEL				40514
 #define MENUPAD_EDIT_SELECTALL			40515
+#define MENUPAD_EDIT_RECALCULATE		40516
 
 
 // about dialog
@@ -0,0 +1,234 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef headerfileresultcache
+#define headerfileresultcache
+
+/*!
+	\file resultcache.h
+    \brief a bounded LRU cache of calculated values
+*/
+
+#include "compileconfig.h"
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+
+
+/*!
+	\brief a bounded LRU cache of calculated values
+
+	the key is a string made from the input string and from all settings which
+	have an influence on parsing (base, angle mode, commas, ids of variables
+	and functions etc.) - settings of displaying are not in the key so the cached
+	values can be printed again with other settings
+
+	when the cache is full the least recently used entry is removed,
+	the size of the cache is given in entries (zero turns the cache off)
+*/
+template<class ValueType>
+class ResultCache
+{
+public:
+
+	typedef std::vector<ValueType> Values;
+
+
+	struct Entry
+	{
+		// the values from the parser's stack (one for each part of the input separated by semicolons)
+		Values values;
+
+		// true if the parser has calculated something
+		bool calculated;
+
+		// the position on the lru list
+		typename std::list<const std::string*>::iterator lru;
+	};
+
+
+	ResultCache(size_t pmax_size = 64)
+	{
+		max_size = pmax_size;
+		hits     = 0;
+		misses   = 0;
+	}
+
+
+	/*!
+		changing the maximum number of entries (zero turns the cache off)
+	*/
+	void SetMaxSize(size_t pmax_size)
+	{
+		max_size = pmax_size;
+
+		while( table.size() > max_size )
+			RemoveOldest();
+	}
+
+
+	size_t GetMaxSize() const
+	{
+		return max_size;
+	}
+
+
+	/*!
+		looking for the key, returning null if there is not such an entry
+		(the entry found becomes the most recently used one)
+	*/
+	const Entry * Find(const std::string & key)
+	{
+		typename Table::iterator i = table.find(key);
+
+		if( i == table.end() )
+		{
+			++misses;
+			return 0;
+		}
+
+		++hits;
+		lru.splice(lru.begin(), lru, i->second.lru);
+
+	return &i->second;
+	}
+
+
+	/*!
+		inserting (or replacing) an entry
+	*/
+	void Insert(const std::string & key, const Values & values, bool calculated)
+	{
+		if( max_size == 0 )
+			return;
+
+		typename Table::iterator i = table.find(key);
+
+		if( i == table.end() )
+		{
+			if( table.size() >= max_size )
+				RemoveOldest();
+
+			i = table.insert( std::make_pair(key, Entry()) ).first;
+			lru.push_front(&i->first);
+			i->second.lru = lru.begin();
+		}
+		else
+		{
+			lru.splice(lru.begin(), lru, i->second.lru);
+		}
+
+		i->second.values     = values;
+		i->second.calculated = calculated;
+	}
+
+
+	void Clear()
+	{
+		table.clear();
+		lru.clear();
+	}
+
+
+	size_t Size() const
+	{
+		return table.size();
+	}
+
+
+	/*!
+		statistics
+	*/
+	unsigned long Hits() const
+	{
+		return hits;
+	}
+
+
+	unsigned long Misses() const
+	{
+		return misses;
+	}
+
+
+	/*!
+		an estimate of memory used by the entries (in bytes), nodes of the map
+		and of the list are counted as their elements plus three pointers
+	*/
+	size_t MemoryUsage() const
+	{
+	size_t size = 0;
+
+		for(typename Table::const_iterator i=table.begin() ; i!=table.end() ; ++i)
+		{
+			size += sizeof(typename Table::value_type) + 3 * sizeof(void*);
+			size += i->first.capacity();
+			size += i->second.values.capacity() * sizeof(ValueType);
+			size += sizeof(const std::string*) + 3 * sizeof(void*);
+		}
+
+	return size;
+	}
+
+
+private:
+
+	typedef std::map<std::string, Entry> Table;
+
+	Table table;
+
+	// the most recently used entry is at the beginning,
+	// the list has pointers to keys in the table (they don't change when the map changes)
+	std::list<const std::string*> lru;
+
+	size_t max_size;
+	unsigned long hits, misses;
+
+
+	void RemoveOldest()
+	{
+		if( lru.empty() )
+			return;
+
+		table.erase( *lru.back() );
+		lru.pop_back();
+	}
+};
+
+
+#endif
@@ -0,0 +1,211 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef headerfilespscqueue
+#define headerfilespscqueue
+
+/*!
+	\file spscqueue.h
+    \brief a lock-free queue for one producer thread and one consumer thread
+*/
+
+#include "compileconfig.h"
+#include <cstddef>
+
+#ifdef _MSC_VER
+#include <windows.h>
+#endif
+
+
+/*!
+	\brief a lock-free queue for one producer thread and one consumer thread
+
+	the queue has a fixed number of slots which are reused, the producer fills
+	the slot returned by Back() and then calls Push(), the consumer reads the slot
+	returned by Front() and then calls Pop() - objects are neither copied nor
+	allocated (e.g. std::string members keep their capacity)
+
+	the producer can wake up the consumer (e.g. by posting a window message) but
+	it should do it only when Push() returns true - then there's no pending wake-up,
+	the consumer calls Woken() before it begins to take items and it must take all
+	of them, in this way there's at most one wake-up message in the system
+*/
+template<class Type, size_t capacity>
+class SPSCQueue
+{
+public:
+
+
+	SPSCQueue()
+	{
+		head    = 0;
+		tail    = 0;
+		pending = 0;
+	}
+
+
+	/*!
+		the producer: returning a free slot or null if the queue is full
+	*/
+	Type * Back()
+	{
+		if( Next(tail) == head )
+			return 0;
+
+	return &items[tail];
+	}
+
+
+	/*!
+		the producer: the slot from Back() is given to the consumer
+
+		returning true if the consumer should be woken up
+	*/
+	bool Push()
+	{
+		// the item must be written before the new tail is seen
+		Barrier();
+		tail = Next(tail);
+		Barrier();
+
+	return Exchange(pending, 1) == 0;
+	}
+
+
+	/*!
+		the consumer: it should be called before taking items after a wake-up
+	*/
+	void Woken()
+	{
+		Exchange(pending, 0);
+		Barrier();
+	}
+
+
+	/*!
+		the consumer: returning the oldest item or null if the queue is empty
+	*/
+	Type * Front()
+	{
+		if( head == tail )
+			return 0;
+
+		// the item is read after the tail
+		Barrier();
+
+	return &items[head];
+	}
+
+
+	/*!
+		the consumer: the slot from Front() is given back to the producer
+	*/
+	void Pop()
+	{
+		Barrier();
+		head = Next(head);
+	}
+
+
+	/*!
+		the consumer: how many items are waiting
+		(the producer can add more in the meantime)
+	*/
+	size_t Size() const
+	{
+		size_t t = tail;
+		size_t h = head;
+
+		if( t >= h )
+			return t - h;
+
+	return t + slots - h;
+	}
+
+
+private:
+
+	// one slot is always free (so we can distinguish a full queue from an empty one)
+	static const size_t slots = capacity + 1;
+
+	Type items[slots];
+
+	// changed only by the consumer
+	volatile size_t head;
+
+	// changed only by the producer
+	volatile size_t tail;
+
+	// there is a wake-up which the consumer has not taken yet
+	volatile long pending;
+
+
+	static size_t Next(size_t index)
+	{
+		return (index + 1 == slots) ? 0 : index + 1;
+	}
+
+
+	static void Barrier()
+	{
+		#ifdef _MSC_VER
+			MemoryBarrier();
+		#else
+			__sync_synchronize();
+		#endif
+	}
+
+
+	static long Exchange(volatile long & value, long new_value)
+	{
+		#ifdef _MSC_VER
+			return InterlockedExchange(&value, new_value);
+		#else
+			long old = __sync_lock_test_and_set(&value, new_value);
+			__sync_synchronize();
+
+			return old;
+		#endif
+	}
+
+
+	SPSCQueue(const SPSCQueue &);
+	SPSCQueue & operator=(const SPSCQueue &);
+};
+
+
+#endif
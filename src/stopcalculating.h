@@ -44,6 +44,7 @@
 */
 
 #include "compileconfig.h"
+#include "stopflag.h"
 #include <ttmath/ttmathtypes.h>
 #include <windows.h>
 #include <cstdio>
@@ -66,8 +67,12 @@
 
 	there'll be only one object of this class
 	(it'll be as an variable of ThreadController class)
+
+	WasStopSignal() only reads the atomic flag from StopFlag (it is called from
+	hot loops), the system event is set together with the flag and is used only
+	when someone wants to wait for the stop signal (WaitForStop())
 */
-class NewStopCalculating : public ttmath::StopCalculating
+class NewStopCalculating : public StopFlag
 {
 public:
 
@@ -118,6 +123,7 @@ public:
 	*/
 	void Stop() volatile
 	{
+		StopFlag::Stop();
 		SetEvent(stop);
 	}
 
@@ -130,20 +136,18 @@ public:
 	*/
 	void Start() volatile
 	{
+		StopFlag::Start();
 		ResetEvent(stop);
 	}
 
 
 	/*!
-		it returns 'true' if there was a stop signal
-
-		it's useful for the second thread and functions which take plenty of time
-		for calculating, when this method returns 'true' those methods break the
-		calculations and return without returning a correct value
+		waiting (blocking) for the stop signal at most 'milliseconds'
+		returning 'true' if there was the stop signal
 	*/
-	virtual bool WasStopSignal() const volatile
+	bool WaitForStop(DWORD milliseconds) const volatile
 	{
-		if( WaitForSingleObject(stop,0) == WAIT_OBJECT_0 )
+		if( WaitForSingleObject(stop, milliseconds) == WAIT_OBJECT_0 )
 			return true;
 
 	return false;
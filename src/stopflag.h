@@ -0,0 +1,125 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef headerfilestopflag
+#define headerfilestopflag
+
+/*!
+	\file stopflag.h
+    \brief a stop object based on an atomic flag (it doesn't use the win32 api)
+*/
+
+#include "compileconfig.h"
+#include <ttmath/ttmathtypes.h>
+
+#ifdef _MSC_VER
+#include <windows.h>
+#endif
+
+
+/*!
+	\brief a stop object which is only a flag in memory
+
+	ttmath calls WasStopSignal() very often from its hot loops (Factorial, Gamma,
+	series expansions) so checking the flag must be cheap - it is only one read from
+	memory, there is no system call and no locked instruction
+
+	Stop() and Start() are called by another thread (the gui thread or
+	a benchmark), they write the flag with a full memory barrier so the calculating
+	thread will see the change during its next poll
+
+	this object cannot be used for blocking waits, if you need it (as the gui does)
+	take NewStopCalculating which has also a system event
+*/
+class StopFlag : public ttmath::StopCalculating
+{
+public:
+
+
+	StopFlag()
+	{
+		flag = 0;
+	}
+
+
+	/*!
+		setting the stop signal
+	*/
+	void Stop() volatile
+	{
+		Set(1);
+	}
+
+
+	/*!
+		clearing the stop signal (before the calculations)
+	*/
+	void Start() volatile
+	{
+		Set(0);
+	}
+
+
+	/*!
+		it returns 'true' if there was a stop signal
+	*/
+	virtual bool WasStopSignal() const volatile
+	{
+		return flag != 0;
+	}
+
+
+private:
+
+// aligned 'long' is read and written atomically on all our platforms
+long flag;
+
+
+	void Set(long value) volatile
+	{
+		#ifdef _MSC_VER
+			InterlockedExchange(const_cast<long*>(&flag), value);
+		#else
+			__sync_lock_test_and_set(&flag, value);
+			__sync_synchronize();
+		#endif
+	}
+
+};
+
+
+#endif
@@ -0,0 +1,591 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "compileconfig.h"
+#include "sweep.h"
+
+
+
+Sweep::Sweep()
+{
+	threads     = 1;
+	stop_object = 0;
+	format      = csv;
+	separator   = ',';
+	count       = 0;
+	chunks      = 0;
+	out         = 0;
+	direct      = false;
+	max_queue   = 0;
+	running     = 0;
+	stop        = false;
+	points      = 0;
+	errors      = 0;
+	steals      = 0;
+	compiled    = false;
+}
+
+
+Sweep::~Sweep()
+{
+	DeleteWorkers();
+}
+
+
+void Sweep::SetThreads(unsigned int pthreads)
+{
+	threads = pthreads;
+}
+
+
+void Sweep::SetStopObject(const volatile ttmath::StopCalculating * pstop_object)
+{
+	stop_object = pstop_object;
+}
+
+
+void Sweep::SetFormat(Format pformat)
+{
+	format = pformat;
+}
+
+
+unsigned long Sweep::Points() const
+{
+	return points;
+}
+
+
+unsigned long Sweep::Errors() const
+{
+	return errors;
+}
+
+
+unsigned long Sweep::Steals() const
+{
+	return steals;
+}
+
+
+bool Sweep::Compiled() const
+{
+	return compiled;
+}
+
+
+bool Sweep::WasStopSignal()
+{
+	return stop_object && stop_object->WasStopSignal();
+}
+
+
+/*!
+	counting the points of the grid
+*/
+ttmath::ErrorCode Sweep::Prepare(const std::vector<TabulationAxis> & axes)
+{
+	if( axes.empty() || axes.size() > max_axes )
+		return ttmath::err_improper_amount_of_arguments;
+
+	counts.resize(axes.size());
+	count = 1;
+
+	for(size_t i=0 ; i<axes.size() ; ++i)
+	{
+		counts[i] = axes[i].count;
+
+		if( count != 0 && counts[i] > static_cast<unsigned long>(-1) / count )
+			return ttmath::err_overflow;
+
+		count *= counts[i];
+	}
+
+	chunks = count / chunk_points + ((count % chunk_points) ? 1 : 0);
+
+return ttmath::err_ok;
+}
+
+
+void Sweep::WriteHeader(const std::vector<TabulationAxis> & axes, const char * expression)
+{
+std::string line;
+
+	for(size_t i=0 ; i<axes.size() ; ++i)
+	{
+		AppendCsvField(line, axes[i].variable, separator);
+		line += separator;
+	}
+
+	AppendCsvField(line, expression, separator);
+	line += '\n';
+
+	out->write(line.c_str(), line.size());
+}
+
+
+ttmath::ErrorCode Sweep::Run(const char * expression,
+							 const std::vector<TabulationAxis> & axes,
+							 const EvaluatorSettings & settings,
+							 const ttmath::Objects & variables,
+							 const ttmath::Objects & functions,
+							 Languages * languages,
+							 std::ostream & pout)
+{
+	DeleteWorkers();
+
+	out       = &pout;
+	separator = (format == tsv) ? '\t' : CsvSeparator(settings);
+	stop      = false;
+	points    = 0;
+	errors    = 0;
+	steals    = 0;
+	compiled  = false;
+
+	ttmath::ErrorCode code = Prepare(axes);
+
+	if( code != ttmath::err_ok )
+		return code;
+
+	unsigned int threads_count = (threads == 0) ? HowManyProcessors() : threads;
+
+	if( threads_count > chunks )
+		threads_count = (unsigned int)chunks;
+
+	if( threads_count == 0 )
+		threads_count = 1;
+
+	// each worker gets its own copy of the settings, tables and the compiled expression
+	for(unsigned int i=0 ; i<threads_count ; ++i)
+	{
+		Worker * worker = new Worker();
+		worker->sweep   = this;
+		worker->calc    = CreateTabulationWorker(settings.precision);
+		worker->buffer  = GetBuffer();
+		worker->points  = 0;
+		worker->errors  = 0;
+		worker->steals  = 0;
+		worker->index.resize(axes.size());
+		workers.push_back(worker);
+
+		worker->calc->SetStopObject(stop_object);
+		code = worker->calc->Init(expression, axes, settings, variables, functions, languages);
+
+		if( code != ttmath::err_ok )
+		{
+			DeleteWorkers();
+			return code;
+		}
+	}
+
+	compiled = workers[0]->calc->Compiled();
+	WriteHeader(axes, expression);
+	Divide();
+
+	if( workers.size() == 1 )
+	{
+		direct = true;
+		WorkerLoop(*workers[0]);
+	}
+	else
+	{
+		direct = false;
+		RunThreads();
+	}
+
+	for(size_t i=0 ; i<workers.size() ; ++i)
+	{
+		points += workers[i]->points;
+		errors += workers[i]->errors;
+		steals += workers[i]->steals;
+	}
+
+	DeleteWorkers();
+
+	if( stop || points < count )
+		return ttmath::err_interrupt;
+
+return ttmath::err_ok;
+}
+
+
+/*!
+	each worker gets an equal range of chunks
+*/
+void Sweep::Divide()
+{
+	unsigned long per  = chunks / workers.size();
+	unsigned long rest = chunks % workers.size();
+	unsigned long first = 0;
+
+	for(size_t i=0 ; i<workers.size() ; ++i)
+	{
+		workers[i]->begin = first;
+		first += per + ((i < rest) ? 1 : 0);
+		workers[i]->end   = first;
+	}
+}
+
+
+/*!
+	taking the next chunk from our own range or stealing a new range,
+	returning false when there are no more chunks
+*/
+bool Sweep::TakeChunk(Worker & worker, unsigned long & chunk)
+{
+	do
+	{
+		MutexLock lock(worker.range_mutex);
+
+		if( worker.begin < worker.end )
+		{
+			chunk = worker.begin++;
+			return true;
+		}
+	}
+	while( Steal(worker) );
+
+return false;
+}
+
+
+/*!
+	taking the upper half of the biggest range of the other workers,
+	returning false if all ranges are empty
+	(only one mutex is locked at a time)
+*/
+bool Sweep::Steal(Worker & worker)
+{
+Worker * victim = 0;
+unsigned long most = 0;
+unsigned long first, last;
+
+	for(size_t i=0 ; i<workers.size() ; ++i)
+	{
+		if( workers[i] == &worker )
+			continue;
+
+		MutexLock lock(workers[i]->range_mutex);
+		unsigned long left = workers[i]->end - workers[i]->begin;
+
+		if( left > most )
+		{
+			most   = left;
+			victim = workers[i];
+		}
+	}
+
+	if( !victim )
+		return false;
+
+	{
+		MutexLock lock(victim->range_mutex);
+		unsigned long left = victim->end - victim->begin;
+
+		// someone else was faster, we will look again
+		if( left == 0 )
+			return true;
+
+		last         = victim->end;
+		first        = last - (left + 1) / 2;
+		victim->end  = first;
+	}
+
+	{
+		MutexLock lock(worker.range_mutex);
+		worker.begin = first;
+		worker.end   = last;
+	}
+
+	++worker.steals;
+
+return true;
+}
+
+
+/*!
+	returning false if the sweep should stop
+*/
+bool Sweep::CalculateChunk(Worker & worker, unsigned long chunk)
+{
+	unsigned long first = chunk * chunk_points;
+	unsigned long last  = (count - first > chunk_points) ? first + chunk_points : count;
+	unsigned long rest  = first;
+	size_t axes = counts.size();
+
+	// indices of the first point, the next ones are increased like digits of a counter
+	for(size_t i=axes ; i-- > 0 ; )
+	{
+		worker.index[i] = rest % counts[i];
+		rest /= counts[i];
+	}
+
+	for(unsigned long p=first ; p<last ; ++p)
+	{
+		if( WasStopSignal() )
+			return false;
+
+		worker.calc->Calculate(&worker.index[0], worker.row);
+		++worker.points;
+
+		if( worker.row.code != ttmath::err_ok )
+			++worker.errors;
+
+		FormatRow(worker);
+
+		if( worker.buffer->size() >= buffer_size && !Flush(worker) )
+			return false;
+
+		for(size_t i=axes ; i-- > 0 ; )
+		{
+			if( ++worker.index[i] < counts[i] )
+				break;
+
+			worker.index[i] = 0;
+		}
+	}
+
+return true;
+}
+
+
+void Sweep::FormatRow(Worker & worker)
+{
+std::string & line = *worker.buffer;
+
+	for(size_t i=0 ; i<worker.row.x.size() ; ++i)
+	{
+		AppendCsvField(line, worker.row.x[i], separator);
+		line += separator;
+	}
+
+	AppendCsvField(line, worker.row.value, separator);
+	line += '\n';
+}
+
+
+/*!
+	a new or a reused buffer (called with the mutex locked or before the threads are started)
+*/
+std::string * Sweep::GetBuffer()
+{
+std::string * buffer;
+
+	if( !free_buffers.empty() )
+	{
+		buffer = free_buffers.back();
+		free_buffers.pop_back();
+	}
+	else
+	{
+		buffer = new std::string();
+		buffer->reserve(buffer_size + 1024);
+		buffers.push_back(buffer);
+	}
+
+	buffer->clear();
+
+return buffer;
+}
+
+
+/*!
+	giving the worker's buffer to the writer, the worker waits if the queue is full,
+	returning false if the sweep should stop
+*/
+bool Sweep::Flush(Worker & worker)
+{
+	if( worker.buffer->empty() )
+		return true;
+
+	if( direct )
+	{
+		out->write(worker.buffer->c_str(), worker.buffer->size());
+		worker.buffer->clear();
+
+		if( !out->good() )
+			stop = true;
+
+		return !stop;
+	}
+
+	MutexLock lock(mutex);
+
+	while( queue.size() >= max_queue && !stop )
+		queue_not_full.Wait(mutex);
+
+	if( stop )
+	{
+		worker.buffer->clear();
+		return false;
+	}
+
+	queue.push_back(worker.buffer);
+	worker.buffer = GetBuffer();
+	queue_not_empty.Signal();
+
+return true;
+}
+
+
+void * Sweep::WorkerThread(void * arg)
+{
+	Worker * worker = reinterpret_cast<Worker*>(arg);
+	worker->sweep->WorkerLoop(*worker);
+
+return 0;
+}
+
+
+void Sweep::WorkerLoop(Worker & worker)
+{
+unsigned long chunk;
+bool cont = true;
+
+	while( cont && TakeChunk(worker, chunk) )
+		cont = CalculateChunk(worker, chunk);
+
+	if( cont )
+		Flush(worker);
+
+	if( !direct )
+	{
+		MutexLock lock(mutex);
+		--running;
+		queue_not_empty.Signal();
+	}
+}
+
+
+void Sweep::RunThreads()
+{
+std::vector<bool> started(workers.size(), false);
+
+	running   = workers.size();
+	max_queue = workers.size() * buffers_per_thread;
+
+	for(size_t i=0 ; i<workers.size() ; ++i)
+	{
+		started[i] = StartThread(workers[i]->thread, WorkerThread, workers[i]);
+
+		if( !started[i] )
+		{
+			// its range will be stolen by the others
+			MutexLock lock(mutex);
+			--running;
+		}
+	}
+
+	if( running == 0 )
+	{
+		// no thread could be created
+		direct = true;
+		WorkerLoop(*workers[0]);
+		return;
+	}
+
+	WriterLoop();
+
+	for(size_t i=0 ; i<workers.size() ; ++i)
+		if( started[i] )
+			JoinThread(workers[i]->thread);
+}
+
+
+/*!
+	the thread which has called Run() writes full buffers to the stream
+	until all workers have finished
+*/
+void Sweep::WriterLoop()
+{
+	mutex.Lock();
+
+	while( true )
+	{
+		while( queue.empty() && running > 0 )
+			queue_not_empty.Wait(mutex);
+
+		if( queue.empty() )
+			break;
+
+		std::string * buffer = queue.front();
+		queue.pop_front();
+		queue_not_full.Signal();
+		bool write = !stop;
+		mutex.Unlock();
+
+		// writing without the lock
+		bool ok = true;
+
+		if( write )
+		{
+			out->write(buffer->c_str(), buffer->size());
+			ok = out->good() && !WasStopSignal();
+		}
+
+		mutex.Lock();
+		buffer->clear();
+		free_buffers.push_back(buffer);
+
+		if( !ok && !stop )
+		{
+			stop = true;
+			queue_not_full.Broadcast();
+		}
+	}
+
+	mutex.Unlock();
+}
+
+
+void Sweep::DeleteWorkers()
+{
+	for(size_t i=0 ; i<workers.size() ; ++i)
+	{
+		delete workers[i]->calc;
+		delete workers[i];
+	}
+
+	workers.clear();
+
+	for(size_t i=0 ; i<buffers.size() ; ++i)
+		delete buffers[i];
+
+	buffers.clear();
+	free_buffers.clear();
+	queue.clear();
+}
@@ -0,0 +1,235 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef headerfilesweep
+#define headerfilesweep
+
+/*!
+	\file sweep.h
+    \brief calculating an expression over a grid of many variables
+*/
+
+#include "compileconfig.h"
+#include "tabulation.h"
+#include "threads.h"
+
+#include <ttmath/ttmathobjects.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <ostream>
+
+
+/*!
+	\brief a parameter sweep: calculating an expression for every point
+	of the Cartesian grid of a few variables (axes)
+
+	each axis is variable = start + i * step (i = 0 .. count-1), points are numbered
+	in the row-major order (the last axis changes the fastest) and divided into chunks,
+	at the beginning each thread gets an equal range of chunks and takes them from
+	the front of its range, a thread which has finished its range steals the upper half
+	of the biggest range left by the other threads (work stealing) - so expensive parts
+	of the grid don't leave the other threads idle
+
+	each worker has its own compiled expression (TabulationWorkerBase) and formats rows
+	into its own text buffer, full buffers are given to a bounded queue and written
+	to the stream by the thread which has called Run() - when the stream is slower than
+	the workers they wait, so the memory doesn't grow with the number of points
+
+	rows are written in the order in which chunks have been finished (not in the order
+	of the grid) but each row has values of all variables,
+	the output is CSV (the separator as in CsvSeparator()) or TSV
+
+	usage:
+		Sweep sweep;
+		sweep.SetThreads(0);
+		code = sweep.Run("x*y", axes, settings, variables, functions, &languages, std::cout);
+*/
+class Sweep
+{
+public:
+
+	/*!
+		how many variables can be given
+	*/
+	static const size_t max_axes = 4;
+
+
+	/*!
+		how many points there are in one chunk
+	*/
+	static const unsigned long chunk_points = 256;
+
+
+	/*!
+		the size of a text buffer after which it is given to the writer
+	*/
+	static const size_t buffer_size = 64 * 1024;
+
+
+	/*!
+		how many full buffers can wait for the writer (for one thread)
+	*/
+	static const size_t buffers_per_thread = 2;
+
+
+	enum Format
+	{
+		csv, tsv
+	};
+
+
+	Sweep();
+	~Sweep();
+
+
+	/*!
+		how many threads are used by Run(), zero means as many as processors (default: 1)
+	*/
+	void SetThreads(unsigned int threads);
+
+
+	/*!
+		the object is checked between points (and passed to the parsers)
+	*/
+	void SetStopObject(const volatile ttmath::StopCalculating * stop_object);
+
+
+	/*!
+		the format of rows (default: csv)
+	*/
+	void SetFormat(Format format);
+
+
+	/*!
+		calculating the expression for all points of the grid and writing them
+		(with a header) to the stream
+
+		returning an error if there are too many axes or too many points (more than
+		fits in unsigned long), if a name is incorrect or if start or step of an axis
+		could not be calculated (nothing is written then), err_interrupt if the sweep
+		was stopped (by the stop object or by an error of the stream)
+	*/
+	ttmath::ErrorCode Run(const char * expression,
+						  const std::vector<TabulationAxis> & axes,
+						  const EvaluatorSettings & settings,
+						  const ttmath::Objects & variables,
+						  const ttmath::Objects & functions,
+						  Languages * languages,
+						  std::ostream & out);
+
+
+	/*!
+		statistics of the last Run()
+	*/
+	unsigned long Points() const;
+	unsigned long Errors() const;
+	unsigned long Steals() const;
+	bool Compiled() const;
+
+
+private:
+
+	struct Worker
+	{
+		Sweep * sweep;
+		pthread_t thread;
+		TabulationWorkerBase * calc;
+
+		// chunks which have not been taken yet: [begin, end)
+		// (the owner takes from the front, thieves take from the back)
+		Mutex range_mutex;
+		unsigned long begin, end;
+
+		TabulationWorkerBase::Row row;
+		std::vector<unsigned long> index;
+		std::string * buffer;
+
+		unsigned long points, errors, steals;
+	};
+
+	unsigned int threads;
+	const volatile ttmath::StopCalculating * stop_object;
+	Format format;
+	char separator;
+
+	std::vector<Worker*> workers;
+	std::vector<unsigned long> counts;		// points on each axis
+	unsigned long count;					// points of the whole grid
+	unsigned long chunks;
+
+	std::ostream * out;
+	bool direct;							// buffers are written at once (there are no threads)
+
+	// full buffers waiting for the writer and empty buffers to reuse
+	std::deque<std::string*> queue;
+	std::vector<std::string*> free_buffers;
+	std::vector<std::string*> buffers;		// all allocated buffers
+	size_t max_queue;
+	size_t running;							// workers which have not finished yet
+
+	bool stop;
+	unsigned long points, errors, steals;
+	bool compiled;
+
+	Mutex mutex;
+	Condition queue_not_empty;				// signaled when a buffer is put (or a worker has finished)
+	Condition queue_not_full;				// signaled when a buffer is taken (or stop)
+
+	ttmath::ErrorCode Prepare(const std::vector<TabulationAxis> & axes);
+	void WriteHeader(const std::vector<TabulationAxis> & axes, const char * expression);
+	void Divide();
+	bool TakeChunk(Worker & worker, unsigned long & chunk);
+	bool Steal(Worker & worker);
+	bool CalculateChunk(Worker & worker, unsigned long chunk);
+	void FormatRow(Worker & worker);
+	bool Flush(Worker & worker);
+	std::string * GetBuffer();
+	bool WasStopSignal();
+	void RunThreads();
+	void WriterLoop();
+	void DeleteWorkers();
+
+	static void * WorkerThread(void * arg);
+	void WorkerLoop(Worker & worker);
+
+	Sweep(const Sweep &);
+	Sweep & operator=(const Sweep &);
+};
+
+
+#endif
@@ -0,0 +1,305 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "compileconfig.h"
+#include "symboltable.h"
+#include <cstring>
+
+
+
+SymbolTable::SymbolTable()
+{
+	max_name_len = 0;
+}
+
+
+void SymbolTable::Clear()
+{
+	pool.clear();
+	symbols.clear();
+	slots.clear();
+	visited.clear();
+	marked.clear();
+	pending.clear();
+	max_name_len = 0;
+}
+
+
+void SymbolTable::Build(const ttmath::Objects * variables, const ttmath::Objects * functions)
+{
+ttmath::Objects::CIterator i;
+size_t count = 0, size;
+
+	Clear();
+
+	if( variables )
+		for(i=variables->Begin() ; i!=variables->End() ; ++i)
+			++count;
+
+	if( functions )
+		for(i=functions->Begin() ; i!=functions->End() ; ++i)
+			++count;
+
+	// at least half of the slots are empty
+	for(size = 16 ; size < count * 2 ; size *= 2);
+
+	slots.resize(size, 0);
+	symbols.reserve(count);
+
+	if( variables )
+		for(i=variables->Begin() ; i!=variables->End() ; ++i)
+		{
+			size_t index = Intern(i->first);
+			symbols[index].variable = AddString(i->second.value);
+		}
+
+	if( functions )
+		for(i=functions->Begin() ; i!=functions->End() ; ++i)
+		{
+			size_t index = Intern(i->first);
+			symbols[index].function = AddString(i->second.value);
+			symbols[index].param    = i->second.param;
+		}
+
+	visited.resize(symbols.size(), 0);
+}
+
+
+const SymbolTable::Symbol * SymbolTable::Find(const char * name, size_t len) const
+{
+	if( slots.empty() )
+		return 0;
+
+	size_t index = slots[ Slot(name, len, Hash(name, len)) ];
+
+	if( index == 0 )
+		return 0;
+
+return &symbols[index - 1];
+}
+
+
+void SymbolTable::Select(const char * input, ttmath::Objects & used_variables, ttmath::Objects & used_functions)
+{
+	used_variables.Clear();
+	used_functions.Clear();
+
+	if( symbols.empty() )
+		return;
+
+	Scan(input, used_variables, used_functions);
+
+	// values of variables and bodies of functions can use other objects
+	while( !pending.empty() )
+	{
+		size_t offset = pending.back();
+		pending.pop_back();
+		Scan(String(offset), used_variables, used_functions);
+	}
+
+	for(size_t i=0 ; i<marked.size() ; ++i)
+		visited[marked[i]] = 0;
+
+	marked.clear();
+}
+
+
+size_t SymbolTable::MemoryUsage() const
+{
+size_t size = sizeof(*this);
+
+	size += pool.capacity();
+	size += symbols.capacity() * sizeof(Symbol);
+	size += slots.capacity()   * sizeof(size_t);
+	size += visited.capacity();
+	size += marked.capacity()  * sizeof(size_t);
+	size += pending.capacity() * sizeof(size_t);
+
+return size;
+}
+
+
+/*!
+	FNV-1a
+*/
+unsigned long SymbolTable::Hash(const char * name, size_t len)
+{
+unsigned long hash = 2166136261ul;
+
+	for(size_t i=0 ; i<len ; ++i)
+	{
+		hash ^= (unsigned char)name[i];
+		hash *= 16777619ul;
+		hash &= 0xfffffffful;
+	}
+
+return hash;
+}
+
+
+/*!
+	the same characters as ttmath accepts in names
+*/
+bool SymbolTable::IsNameCharacter(char c)
+{
+	return IsFirstNameCharacter(c) || (c>='0' && c<='9');
+}
+
+
+bool SymbolTable::IsFirstNameCharacter(char c)
+{
+	return (c>='a' && c<='z') || (c>='A' && c<='Z') || c=='_';
+}
+
+
+/*!
+	returning the slot with the name or the empty slot where the name should be put
+*/
+size_t SymbolTable::Slot(const char * name, size_t len, unsigned long hash) const
+{
+size_t mask = slots.size() - 1;
+size_t i    = hash & mask;
+
+	for( ; slots[i] != 0 ; i = (i + 1) & mask )
+	{
+		const Symbol & s = symbols[slots[i] - 1];
+
+		if( s.hash == hash && s.name_len == len && memcmp(&pool[s.name], name, len) == 0 )
+			break;
+	}
+
+return i;
+}
+
+
+size_t SymbolTable::AddString(const std::string & str)
+{
+size_t offset = pool.size();
+
+	pool.insert(pool.end(), str.begin(), str.end());
+	pool.push_back(0);
+
+return offset;
+}
+
+
+/*!
+	returning the index of the name (it is added if it doesn't exist)
+*/
+size_t SymbolTable::Intern(const std::string & name)
+{
+unsigned long hash = Hash(name.c_str(), name.size());
+size_t slot        = Slot(name.c_str(), name.size(), hash);
+
+	if( slots[slot] != 0 )
+		return slots[slot] - 1;
+
+	Symbol s;
+	s.name     = AddString(name);
+	s.name_len = name.size();
+	s.variable = npos;
+	s.function = npos;
+	s.param    = 0;
+	s.hash     = hash;
+
+	symbols.push_back(s);
+	slots[slot] = symbols.size();
+
+	if( name.size() > max_name_len )
+		max_name_len = name.size();
+
+return symbols.size() - 1;
+}
+
+
+void SymbolTable::Scan(const char * str, ttmath::Objects & used_variables, ttmath::Objects & used_functions)
+{
+	while( *str )
+	{
+		if( !IsNameCharacter(*str) )
+		{
+			++str;
+			continue;
+		}
+
+		const char * start = str;
+
+		while( IsNameCharacter(*str) )
+			++str;
+
+		// the parser reads a name to the end of such a run but the name can begin
+		// after a number (e.g. "2x" or "1fg" in base 16), so we take every part
+		// beginning with a letter (names longer than max_name_len are not defined)
+		if( size_t(str - start) > max_name_len )
+			start = str - max_name_len;
+
+		for( ; start < str ; ++start )
+			if( IsFirstNameCharacter(*start) )
+				Use(start, str - start, used_variables, used_functions);
+	}
+}
+
+
+void SymbolTable::Use(const char * name, size_t len, ttmath::Objects & used_variables, ttmath::Objects & used_functions)
+{
+	const Symbol * s = Find(name, len);
+
+	if( !s )
+		return;
+
+	size_t index = s - &symbols[0];
+
+	if( visited[index] )
+		return;
+
+	visited[index] = 1;
+	marked.push_back(index);
+
+	std::string str_name(name, len);
+
+	if( s->variable != npos )
+	{
+		used_variables.Add(str_name, String(s->variable));
+		pending.push_back(s->variable);
+	}
+
+	if( s->function != npos )
+	{
+		used_functions.Add(str_name, String(s->function), s->param);
+		pending.push_back(s->function);
+	}
+}
@@ -0,0 +1,190 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef headerfilesymboltable
+#define headerfilesymboltable
+
+/*!
+	\file symboltable.h
+    \brief a hashed table of names of user-defined variables and functions
+*/
+
+#include "compileconfig.h"
+#include <ttmath/ttmathobjects.h>
+#include <string>
+#include <vector>
+
+
+/*!
+	\brief a hashed table of names of user-defined variables and functions
+
+	ttmath::Parser looks up names in ttmath::Objects which is an ordered map,
+	with thousands of variables each lookup makes many comparisons of strings
+	(and the parser looks up a variable each time it is used in the input or
+	in a value of another variable)
+
+	this table is built once from the tables of variables and functions (when
+	they have changed), names are interned - each name is kept only once in one
+	pool of characters together with values of variables and bodies of functions
+	and has its number, the table doesn't point to the ttmath::Objects so they
+	can be released after Build()
+
+	Select() takes an input string and copies only the objects which can be used
+	by the input (directly or through values of variables and bodies of functions)
+	into small ttmath::Objects tables, these tables are given to the parser
+	instead of the whole ones - the result is the same but the parser searches
+	only a few objects
+
+	the ordered ttmath::Objects are still used by the gui for showing the lists
+	of variables and functions (they are sorted there)
+*/
+class SymbolTable
+{
+public:
+
+	/*!
+		a name (one for a variable and a function of the same name)
+	*/
+	struct Symbol
+	{
+		// offsets in the pool
+		size_t name;
+		size_t name_len;
+
+		// the value of the variable and the body of the function,
+		// npos if there is not such a variable or function
+		size_t variable;
+		size_t function;
+
+		// the number of parameters of the function
+		int param;
+
+		unsigned long hash;
+	};
+
+	static const size_t npos = size_t(-1);
+
+
+	SymbolTable();
+
+
+	/*!
+		building the table from the tables of variables and functions
+		(the pointers can be null)
+	*/
+	void Build(const ttmath::Objects * variables, const ttmath::Objects * functions);
+
+
+	/*!
+		clearing the table
+	*/
+	void Clear();
+
+
+	/*!
+		looking for a name, returning null if neither a variable nor a function
+		of this name is defined
+	*/
+	const Symbol * Find(const char * name, size_t len) const;
+
+
+	/*!
+		the name, the value of the variable or the body of the function of a symbol
+		(they are terminated by a zero)
+	*/
+	const char * String(size_t offset) const
+	{
+		return &pool[offset];
+	}
+
+
+	/*!
+		copying into 'used_variables' and 'used_functions' all the variables and
+		functions which can be referenced by 'input', the tables are cleared first
+
+		we don't parse the input but we take every name-like part of it, so it can
+		copy more objects than needed but never less
+	*/
+	void Select(const char * input, ttmath::Objects & used_variables, ttmath::Objects & used_functions);
+
+
+	/*!
+		how many names there are
+	*/
+	size_t Size() const
+	{
+		return symbols.size();
+	}
+
+
+	/*!
+		an estimate of memory used by the table (in bytes)
+	*/
+	size_t MemoryUsage() const;
+
+
+private:
+
+	std::vector<char> pool;
+	std::vector<Symbol> symbols;
+
+	// indexes to 'symbols' plus one, zero means an empty slot
+	// (open addressing with linear probing, the size is a power of two)
+	std::vector<size_t> slots;
+
+	// the longest name, longer parts of the input are not looked up
+	size_t max_name_len;
+
+	// used by Select()
+	std::vector<unsigned char> visited;
+	std::vector<size_t> marked;
+	std::vector<size_t> pending;
+
+
+	static unsigned long Hash(const char * name, size_t len);
+	static bool IsNameCharacter(char c);
+	static bool IsFirstNameCharacter(char c);
+
+	size_t Slot(const char * name, size_t len, unsigned long hash) const;
+	size_t AddString(const std::string & str);
+	size_t Intern(const std::string & name);
+	void Scan(const char * str, ttmath::Objects & used_variables, ttmath::Objects & used_functions);
+	void Use(const char * name, size_t len, ttmath::Objects & used_variables, ttmath::Objects & used_functions);
+};
+
+
+#endif
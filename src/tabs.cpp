@@ -46,6 +46,7 @@ int tab_functions;
 int tab_precision;
 int tab_display;
 int tab_convert;
+int tab_tabulation;
 
 ttmath::ErrorCode last_code = ttmath::err_ok;
 
@@ -552,6 +553,7 @@ void SetLanguageTabVariables(HWND hWnd)
 	SetDlgItemText( hWnd,IDC_BUTTON_ADD_VARIABLE, GetPrgRes()->GetLanguages()->GuiMessage(Languages::button_add) );
 	SetDlgItemText( hWnd,IDC_BUTTON_EDIT_VARIABLE, GetPrgRes()->GetLanguages()->GuiMessage(Languages::button_edit) );
 	SetDlgItemText( hWnd,IDC_BUTTON_DELETE_VARIABLE, GetPrgRes()->GetLanguages()->GuiMessage(Languages::button_delete) );
+	SetDlgItemText( hWnd,IDC_LABEL_VARIABLES_FILTER, GetPrgRes()->GetLanguages()->GuiMessage(Languages::list_filter) );
 
 	HWND list = GetDlgItem(hWnd, IDC_VARIABLES_LIST);
 	LVCOLUMN column;
@@ -571,6 +573,7 @@ void SetLanguageTabFunctions(HWND hWnd)
 	SetDlgItemText( hWnd,IDC_BUTTON_ADD_FUNCTION, GetPrgRes()->GetLanguages()->GuiMessage(Languages::button_add) );
 	SetDlgItemText( hWnd,IDC_BUTTON_EDIT_FUNCTION, GetPrgRes()->GetLanguages()->GuiMessage(Languages::button_edit) );
 	SetDlgItemText( hWnd,IDC_BUTTON_DELETE_FUNCTION, GetPrgRes()->GetLanguages()->GuiMessage(Languages::button_delete) );
+	SetDlgItemText( hWnd,IDC_LABEL_FUNCTIONS_FILTER, GetPrgRes()->GetLanguages()->GuiMessage(Languages::list_filter) );
 
 	HWND list = GetDlgItem(hWnd, IDC_FUNCTIONS_LIST);
 	LVCOLUMN column;
@@ -941,6 +944,9 @@ TCITEM tab;
 	TabCtrl_SetItem(hTab,tab_convert, &tab);
 	#endif
 
+	tab.pszText = const_cast<char*>( GetPrgRes()->GetLanguages()->GuiMessage(Languages::tab_tabulation) );
+	TabCtrl_SetItem(hTab,tab_tabulation, &tab);
+
 	SetLanguageTabStandard(  GetPrgRes()->GetTabWindow(tab_standard)  );
 	SetLanguageTabVariables( GetPrgRes()->GetTabWindow(tab_variables) );
 	SetLanguageTabFunctions( GetPrgRes()->GetTabWindow(tab_functions) );
@@ -954,6 +960,8 @@ TCITEM tab;
 	#ifdef TTCALC_CONVERT
 	SetLanguageTabConvert( GetPrgRes()->GetTabWindow(tab_convert) );
 	#endif
+
+	TabulationTab::SetLanguage( GetPrgRes()->GetTabWindow(tab_tabulation) );
 		
 	InvalidateRect(hTab, 0, false);
 }
@@ -1035,7 +1043,7 @@ BOOL WmTabCommand_DisplayOutputChanged(HWND hWnd, UINT message, WPARAM wParam, L
 	if( HIWORD(wParam) != CBN_SELCHANGE )
 		return false;
 
-	GetPrgRes()->GetThreadController()->StopCalculating();
+	GetPrgRes()->GetThreadController()->StopCalculating(false);
 	GetPrgRes()->SetBaseOutput( (int)SendDlgItemMessage(hWnd, IDC_COMBO_DISPLAY_OUTPUT, CB_GETCURSEL, 0, 0) + 2);
 	GetPrgRes()->GetThreadController()->StartCalculating();
 
@@ -1048,7 +1056,7 @@ BOOL WmTabCommand_DisplayDecimalPointChanged(HWND hWnd, UINT message, WPARAM wPa
 	if( HIWORD(wParam) != CBN_SELCHANGE )
 		return false;
 
-	GetPrgRes()->GetThreadController()->StopCalculating();
+	GetPrgRes()->GetThreadController()->StopCalculating(false);
 	GetPrgRes()->SetDecimalPoint( (int)SendDlgItemMessage(hWnd, IDC_COMBO_OUTPUT_DECIMAL_POINT, CB_GETCURSEL, 0, 0) );
 	GetPrgRes()->GetThreadController()->StartCalculating();
 
@@ -1061,7 +1069,7 @@ BOOL WmTabCommand_DisplayRoundingChanged(HWND hWnd, UINT message, WPARAM wParam,
 	if( HIWORD(wParam) != CBN_SELCHANGE )
 		return false;
 
-	GetPrgRes()->GetThreadController()->StopCalculating();
+	GetPrgRes()->GetThreadController()->StopCalculating(false);
 	GetPrgRes()->SetDisplayRounding( (int)SendDlgItemMessage(hWnd, IDC_COMBO_DISPLAY_ROUNDING, CB_GETCURSEL, 0, 0) - 1);
 	GetPrgRes()->GetThreadController()->StartCalculating();
 
@@ -1070,7 +1078,7 @@ return true;
 
 BOOL WmTabCommand_RemoveZeroesChanged(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 {
-	GetPrgRes()->GetThreadController()->StopCalculating();
+	GetPrgRes()->GetThreadController()->StopCalculating(false);
 
 	if( IsDlgButtonChecked(hWnd, IDC_CHECK_REMOVE_ZEROES) == BST_CHECKED )
 		GetPrgRes()->SetRemovingZeroes(true);
@@ -1165,7 +1173,7 @@ BOOL WmTabCommand_SetDisplayAlwaysScientific(HWND hWnd, UINT message, WPARAM wPa
 	if( IsDlgButtonChecked(hWnd, IDC_RADIO_DISPLAY_ALWAYS_SCIENTIFIC) != BST_CHECKED )
 		return false;
 
-	GetPrgRes()->GetThreadController()->StopCalculating();
+	GetPrgRes()->GetThreadController()->StopCalculating(false);
 	GetPrgRes()->SetDisplayAlwaysScientific(true);
 	GetPrgRes()->GetThreadController()->StartCalculating();
 
@@ -1182,7 +1190,7 @@ BOOL WmTabCommand_SetDisplayNotAlwaysScientific(HWND hWnd, UINT message, WPARAM
 	if( IsDlgButtonChecked(hWnd, IDC_RADIO_DISPLAY_NOT_ALWAYS_SCIENTIFIC) != BST_CHECKED )
 		return false;
 
-	GetPrgRes()->GetThreadController()->StopCalculating();
+	GetPrgRes()->GetThreadController()->StopCalculating(false);
 	GetPrgRes()->SetDisplayAlwaysScientific(false);
 	GetPrgRes()->GetThreadController()->StartCalculating();
 
@@ -1204,7 +1212,7 @@ static bool correct_insertion = false;
 		GetDlgItemText(hWnd, IDC_EDIT_DISPLAY_WHEN_SCIENTIFIC, buffer, sizeof(buffer)/sizeof(char));
 		int w2,w1 = atoi(buffer);
 
-		GetPrgRes()->GetThreadController()->StopCalculating();
+		GetPrgRes()->GetThreadController()->StopCalculating(false);
 		GetPrgRes()->SetDisplayWhenScientific(w1);
 		w2 = GetPrgRes()->GetDisplayWhenScientific();
 		GetPrgRes()->GetThreadController()->StartCalculating();
@@ -1399,6 +1407,7 @@ void CreateTabCommandMessagesTable(Messages<BOOL> & cmessages)
 	cmessages.Associate(IDC_BUTTON_ADD_VARIABLE, Variables::WmTabCommand_AddVariable);
 	cmessages.Associate(IDC_BUTTON_EDIT_VARIABLE, Variables::WmTabCommand_EditVariable);
 	cmessages.Associate(IDC_BUTTON_DELETE_VARIABLE, Variables::WmTabCommand_DeleteVariable);
+	cmessages.Associate(IDC_EDIT_VARIABLES_FILTER, Variables::WmTabCommand_FilterChanged);
 
 	cmessages.Associate(IDOK, WmTabCommand_IDOK);
 	cmessages.Associate(IDCANCEL, WmTabCommand_IDCANCEL);
@@ -1406,6 +1415,7 @@ void CreateTabCommandMessagesTable(Messages<BOOL> & cmessages)
 	cmessages.Associate(IDC_BUTTON_ADD_FUNCTION, Functions::WmTabCommand_AddFunction);
 	cmessages.Associate(IDC_BUTTON_EDIT_FUNCTION, Functions::WmTabCommand_EditFunction);
 	cmessages.Associate(IDC_BUTTON_DELETE_FUNCTION, Functions::WmTabCommand_DeleteFunction);
+	cmessages.Associate(IDC_EDIT_FUNCTIONS_FILTER, Functions::WmTabCommand_FilterChanged);
 
 	#ifndef TTCALC_PORTABLE
 
@@ -1428,6 +1438,9 @@ void CreateTabCommandMessagesTable(Messages<BOOL> & cmessages)
 	cmessages.Associate(IDC_COMBO_DISPLAY_GROUPING_DIGITS, WmTabCommand_DisplayGrouping);
 	cmessages.Associate(IDC_COMBO_INPUT_DECIMAL_POINT, WmTabCommand_DisplayInputDecimalPoint);
 	cmessages.Associate(IDC_COMBO_PARAM_SEPARATE, WmTabCommand_DisplayParamSep);
+
+	cmessages.Associate(IDC_BUTTON_TABULATE, TabulationTab::WmTabCommand_Tabulate);
+	cmessages.Associate(IDC_BUTTON_TABULATION_SAVE, TabulationTab::WmTabCommand_Save);
 }
 
 /*
@@ -1530,36 +1543,6 @@ int count  = ListView_GetSelectedCount(list);
 }
 
 
-int FillUpVariableList(HWND list)
-{
-	// we don't have to block the second thread here
-	// because it can only read from variables' table
-	// (we can read and the second thread can read in the same time as well)
-	ttmath::Objects::CIterator iv = GetPrgRes()->GetVariables()->Begin();
-
-	int size;
-	for( size=0 ; iv != GetPrgRes()->GetVariables()->End() ; ++iv, ++size )
-		Variables::AddNewItemToVariableList(list, iv->first, iv->second.value);
-
-return size;
-}
-
-
-int FillUpFunctionList(HWND list)
-{
-	// we don't have to block the second thread here
-	// because it can only read from functions' table
-	// (we can read and the second thread can read in the same time as well)
-	ttmath::Objects::CIterator iv = GetPrgRes()->GetFunctions()->Begin();
-
-	int size;
-	for( size=0 ; iv != GetPrgRes()->GetFunctions()->End() ; ++iv, ++size )
-		Functions::AddNewItemToFunctionList(list, iv->first, iv->second.value, iv->second.param);
-
-return size;
-}
-
-
 BOOL WmInitTabVariables(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 {
 HWND list = GetDlgItem(hWnd, IDC_VARIABLES_LIST);
@@ -1583,7 +1566,10 @@ RECT r;
 	ListView_SetExtendedListViewStyle(list,LVS_EX_FULLROWSELECT);
 	SetDisablingEditDeleteVariableButtons(hWnd);
 
-	if( FillUpVariableList(list) > 0 )
+	// the list is virtual, it doesn't keep the variables
+	Variables::FillUpList(list, "");
+
+	if( ListView_GetItemCount(list) > 0 )
 		ListView_SetItemState(list, 0, LVIS_SELECTED | LVIS_FOCUSED, LVIS_SELECTED | LVIS_FOCUSED);
 
 return true;
@@ -1618,7 +1604,10 @@ RECT r;
 
 	SetDisablingEditDeleteFunctionButtons(hWnd);
 
-	if( FillUpFunctionList(list) > 0 )
+	// the list is virtual, it doesn't keep the functions
+	Functions::FillUpList(list, "");
+
+	if( ListView_GetItemCount(list) > 0 )
 		ListView_SetItemState(list, 0, LVIS_SELECTED | LVIS_FOCUSED, LVIS_SELECTED | LVIS_FOCUSED);
 
 return true;
@@ -1744,7 +1733,19 @@ HWND fun_list    = GetDlgItem(hWnd,IDC_FUNCTIONS_LIST);
 
 	if( pnmh->hwndFrom == var_list )
 	{
-		if( pnmh->code == LVN_ITEMCHANGED )
+		if( pnmh->code == LVN_GETDISPINFO )
+		{
+			Variables::GetDispInfo( (NMLVDISPINFO*) lParam );
+			return true;
+		}
+		else
+		if( pnmh->code == LVN_ODFINDITEM )
+		{
+			SetWindowLong(hWnd, DWL_MSGRESULT, Variables::FindItem(Variables::rows, (NMLVFINDITEM*) lParam));
+			return true;
+		}
+		else
+		if( pnmh->code == LVN_ITEMCHANGED || pnmh->code == LVN_ODSTATECHANGED )
 		{
 			SetDisablingEditDeleteVariableButtons( hWnd );
 			return true;
@@ -1767,7 +1768,19 @@ HWND fun_list    = GetDlgItem(hWnd,IDC_FUNCTIONS_LIST);
 
 	if( pnmh->hwndFrom == fun_list )
 	{
-		if( pnmh->code == LVN_ITEMCHANGED )
+		if( pnmh->code == LVN_GETDISPINFO )
+		{
+			Functions::GetDispInfo( (NMLVDISPINFO*) lParam );
+			return true;
+		}
+		else
+		if( pnmh->code == LVN_ODFINDITEM )
+		{
+			SetWindowLong(hWnd, DWL_MSGRESULT, Variables::FindItem(Functions::rows, (NMLVFINDITEM*) lParam));
+			return true;
+		}
+		else
+		if( pnmh->code == LVN_ITEMCHANGED || pnmh->code == LVN_ODSTATECHANGED )
 		{
 			SetDisablingEditDeleteFunctionButtons( hWnd );
 			return true;
@@ -1838,6 +1851,9 @@ void CreateTabMessagesTable(Messages<BOOL> & messages)
 	messages.Associate(WM_INIT_TAB_CONVERT,		WmInitTabConvert);
 	#endif
 
+	messages.Associate(WM_INIT_TAB_TABULATION,	TabulationTab::WmInitTabTabulation);
+	messages.Associate(WM_TABULATION_FINISHED,	TabulationTab::WmTabulationFinished);
+
 	messages.Associate(WM_NOTIFY,				WmNotify);
 }
 
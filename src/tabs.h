@@ -47,6 +47,7 @@
 #include "messages.h"
 #include <ttmath/ttmathtypes.h>
 #include "programresources.h"
+#include "objectslist.h"
 
 
 
@@ -58,6 +59,7 @@ extern int tab_functions;
 extern int tab_precision;
 extern int tab_display;
 extern int tab_convert;
+extern int tab_tabulation;
 extern ttmath::ErrorCode last_code;
 
 	void PrintErrorCode();
@@ -68,16 +70,27 @@ extern ttmath::ErrorCode last_code;
 	void SetSizeOfConvertingLists(HWND tab, int tabx, int taby, int borderx, int bordery);
 	BOOL WmTabCommand(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
 	void SetSizeOfDialogs();
+	POINT ResizeTabDialog(HWND tab, HWND dialog, int tabx, int taby, int borderx, int bordery);
 
 	namespace Variables
 	{
+		extern ObjectsList rows;
+
 		char * ChangeToSmallLetters(char * string);
 		char * StripWhiteCharacters(char * string);
 
-		int AddNewItemToVariableList(HWND list, const std::string & name, const std::string & value);
 		int GetSelectedItem(HWND list);
 		void SelectOnlyOneItem(HWND list, int id);
 
+		void ShowRows(HWND list, const ObjectsList & rows, const std::string & select);
+		void FilterRows(HWND list, HWND edit, ObjectsList & rows);
+		int FindItem(const ObjectsList & rows, const NMLVFINDITEM * find);
+
+		void FillUpList(HWND list, const std::string & select);
+		void GetDispInfo(NMLVDISPINFO * info);
+
+		BOOL WmTabCommand_FilterChanged(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
+
 		BOOL WmTabCommand_AddVariable(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
 		BOOL WmTabCommand_EditVariable(HWND hWnd, UINT message, WPARAM wParam, LPARAM);
 		BOOL WmTabCommand_DeleteVariable(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
@@ -85,12 +98,29 @@ extern ttmath::ErrorCode last_code;
 
 	namespace Functions
 	{
-		int AddNewItemToFunctionList(HWND list, const std::string & name, const std::string & value, int parameters);
+		extern ObjectsList rows;
+
+		void FillUpList(HWND list, const std::string & select);
+		void GetDispInfo(NMLVDISPINFO * info);
+
+		BOOL WmTabCommand_FilterChanged(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
 
 		BOOL WmTabCommand_AddFunction(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
 		BOOL WmTabCommand_EditFunction(HWND hWnd, UINT message, WPARAM wParam, LPARAM);
 		BOOL WmTabCommand_DeleteFunction(HWND hWnd, UINT message, WPARAM wParam, LPARAM);
 	}
+
+	namespace TabulationTab
+	{
+		BOOL WmTabCommand_Tabulate(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
+		BOOL WmTabCommand_Save(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
+		BOOL WmTabulationFinished(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
+		BOOL WmInitTabTabulation(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
+
+		void SetLanguage(HWND hWnd);
+		void SetSizeOfResult(HWND tab, int tabx, int taby, int borderx, int bordery);
+		void StopThread();
+	}
 }
 
 
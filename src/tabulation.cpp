@@ -0,0 +1,693 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "compileconfig.h"
+#include "tabulation.h"
+#include "compiledexpression.h"
+
+
+
+char CsvSeparator(const EvaluatorSettings & settings)
+{
+	return (settings.decimal_point == ',') ? ';' : ',';
+}
+
+
+void AppendCsvField(std::string & line, const std::string & field, char separator)
+{
+	if( field.find_first_of(std::string(1, separator) + "\"\r\n") == std::string::npos )
+	{
+		line += field;
+		return;
+	}
+
+	line += '"';
+
+	for(size_t i=0 ; i<field.size() ; ++i)
+	{
+		if( field[i] == '"' )
+			line += '"';
+
+		line += field[i];
+	}
+
+	line += '"';
+}
+
+
+
+
+TabulationCsvOutput::TabulationCsvOutput(std::ostream & pout, const EvaluatorSettings & settings) : out(pout)
+{
+	separator = CsvSeparator(settings);
+}
+
+
+void TabulationCsvOutput::SetSeparator(char pseparator)
+{
+	separator = pseparator;
+}
+
+
+void TabulationCsvOutput::PutHeader(const std::string & variable, const std::string & expression)
+{
+	line.clear();
+	AppendCsvField(line, variable, separator);
+	line += separator;
+	AppendCsvField(line, expression, separator);
+	line += '\n';
+
+	out.write(line.c_str(), line.size());
+}
+
+
+bool TabulationCsvOutput::Put(const std::string & x, const std::string & value, ttmath::ErrorCode)
+{
+	line.clear();
+	AppendCsvField(line, x, separator);
+	line += separator;
+	AppendCsvField(line, value, separator);
+	line += '\n';
+
+	out.write(line.c_str(), line.size());
+
+return out.good();
+}
+
+
+
+
+/*!
+	the worker for the given type of values
+*/
+template<class ValueType>
+class TabulationWorker : public TabulationWorkerBase
+{
+public:
+
+	TabulationWorker()
+	{
+		languages    = 0;
+		use_compiled = false;
+	}
+
+
+	ttmath::ErrorCode Init(const char * pexpression,
+						   const std::vector<TabulationAxis> & axes,
+						   const EvaluatorSettings & psettings,
+						   const ttmath::Objects & pvariables,
+						   const ttmath::Objects & pfunctions,
+						   Languages * planguages)
+	{
+		settings  = psettings;
+		languages = planguages;
+
+		names.clear();
+		start.resize(axes.size());
+		step.resize(axes.size());
+		x.resize(axes.size());
+
+		for(size_t i=0 ; i<axes.size() ; ++i)
+		{
+			const std::string & name = axes[i].variable;
+
+			if( !ttmath::Objects::IsNameCorrect(name) )
+				return ttmath::err_incorrect_name;
+
+			for(size_t a=0 ; a<names.size() ; ++a)
+				if( names[a] == name )
+					return ttmath::err_object_exists;
+
+			names.push_back(name);
+
+			// start and step are calculated without our variables
+			ttmath::ErrorCode code = CalculateValue(axes[i].start.c_str(), start[i], pvariables, pfunctions);
+
+			if( code == ttmath::err_ok )
+				code = CalculateValue(axes[i].step.c_str(), step[i], pvariables, pfunctions);
+
+			if( code != ttmath::err_ok )
+				return code;
+		}
+
+		use_compiled = (compiled.Compile(pexpression, names, settings, &pvariables, &pfunctions) == ttmath::err_ok);
+
+		if( !use_compiled )
+		{
+			// the variables are set in our own copy of the table before each point
+			expression = pexpression;
+			variables  = pvariables;
+			functions  = pfunctions;
+
+			for(size_t i=0 ; i<names.size() ; ++i)
+				if( !variables.IsDefined(names[i]) )
+					variables.Add(names[i], "0");
+
+			evaluator.SetVariables(&variables);
+			evaluator.SetFunctions(&functions);
+			evaluator.SetLanguages(languages);
+			evaluator.SetCacheSize(0);
+		}
+
+	return ttmath::err_ok;
+	}
+
+
+	void SetStopObject(const volatile ttmath::StopCalculating * stop_object)
+	{
+		evaluator.SetStopObject(stop_object);
+	}
+
+
+	void Calculate(const unsigned long * index, Row & row)
+	{
+		row.x.resize(x.size());
+		row.value.clear();
+		row.code = ttmath::err_ok;
+
+		try
+		{
+			for(size_t i=0 ; i<x.size() && row.code == ttmath::err_ok ; ++i)
+			{
+				x[i] = ttmath::uint(index[i]);
+
+				if( x[i].Mul(step[i]) || x[i].Add(start[i]) )
+					row.code = ttmath::err_overflow;
+				else
+					Print(x[i], row.x[i]);
+			}
+
+			if( row.code == ttmath::err_ok )
+			{
+				if( use_compiled )
+					CalculateCompiled(row);
+				else
+					CalculateParser(row);
+			}
+		}
+		catch(...)
+		{
+			row.code = ttmath::err_internal_error;
+		}
+
+		if( row.code != ttmath::err_ok )
+			row.value = languages->ErrorMessage(settings.country, row.code);
+	}
+
+
+	bool Compiled() const
+	{
+		return use_compiled;
+	}
+
+
+private:
+
+	EvaluatorSettings settings;
+	Languages * languages;
+	std::vector<std::string> names;
+	std::vector<ValueType> start, step;
+
+	// current values of the variables (bindings of the compiled form)
+	std::vector<ValueType> x;
+
+	// the compiled form
+	CompiledExpression<ValueType> compiled;
+	bool use_compiled;
+	ValueType result;
+
+	// the parser (used only if the expression cannot be compiled)
+	std::string expression;
+	ttmath::Objects variables;
+	ttmath::Objects functions;
+	Evaluator evaluator;
+	std::string x_value;
+
+
+	ttmath::ErrorCode CalculateValue(const char * str, ValueType & value,
+									 const ttmath::Objects & pvariables,
+									 const ttmath::Objects & pfunctions)
+	{
+	ttmath::Parser<ValueType> parser;
+
+		parser.SetBase(settings.base_input);
+		parser.SetDegRadGrad(settings.angle_deg_rad_grad);
+		parser.SetComma(settings.input_comma1, settings.input_comma2);
+		parser.SetGroup(settings.grouping);
+		parser.SetParamSep(settings.param_sep);
+		parser.SetVariables(&pvariables);
+		parser.SetFunctions(&pfunctions);
+
+		ttmath::ErrorCode code = parser.Parse(str);
+
+		if( code != ttmath::err_ok )
+			return code;
+
+		if( parser.stack.size() != 1 || !parser.Calculated() )
+			return ttmath::err_must_be_only_one_value;
+
+		value = parser.stack[0].value;
+
+	return ttmath::err_ok;
+	}
+
+
+	void Print(const ValueType & value, std::string & str)
+	{
+		ttmath::Conv conv;
+		settings.SetConv(conv);
+
+		if( value.ToString(str, conv) )
+			str = languages->GuiMessage(settings.country, Languages::overflow_during_printing);
+	}
+
+
+	void CalculateCompiled(Row & row)
+	{
+		row.code = compiled.Evaluate(x, result);
+
+		if( row.code == ttmath::err_ok )
+			Print(result, row.value);
+	}
+
+
+	/*!
+		a value is given to the parser as a value of the variable: with all digits
+		in the input base and not in the scientific mode
+	*/
+	void SetVariable(const std::string & name, const ValueType & value)
+	{
+		ttmath::Conv conv;
+		conv.base        = settings.base_input;
+		conv.comma       = (unsigned char)settings.input_comma1;
+		conv.scient      = false;
+		conv.scient_from = 4096;
+
+		value.ToString(x_value, conv);
+
+		// a value beginning with a letter would be taken as a name
+		if( settings.base_input > 10 )
+			x_value.insert(x_value[0] == '-' ? 1 : 0, 1, '0');
+
+		variables.EditValue(name, x_value);
+	}
+
+
+	void CalculateParser(Row & row)
+	{
+		for(size_t i=0 ; i<names.size() ; ++i)
+			SetVariable(names[i], x[i]);
+
+		row.code = evaluator.Parse(expression.c_str(), settings);
+
+		if( row.code == ttmath::err_ok && evaluator.Calculated() )
+		{
+			if( evaluator.PrintResult(row.value, "  ;  ") )
+				row.code = ttmath::err_overflow;
+		}
+	}
+};
+
+
+
+template<int level>
+TabulationWorkerBase * CreateTabulationWorkerLevel()
+{
+	return new TabulationWorker<typename TTMathLevel<level>::Type>();
+}
+
+
+typedef TabulationWorkerBase * (*TabulationWorkerFactory)();
+
+#define TTCALC_LADDER_TABULATION_FACTORY(level, exponent_bits, mantissa_bits) \
+	&CreateTabulationWorkerLevel<level>,
+
+static const TabulationWorkerFactory worker_factory[] = {
+	TTCALC_PRECISION_LADDER(TTCALC_LADDER_TABULATION_FACTORY)
+};
+
+
+TabulationWorkerBase * CreateTabulationWorker(int level)
+{
+	if( level < 0 )
+		level = 0;
+
+	if( level >= ttmath_levels )
+		level = ttmath_levels - 1;
+
+return worker_factory[level]();
+}
+
+
+
+
+Tabulation::Tabulation()
+{
+	threads      = 1;
+	stop_object  = 0;
+	count        = 0;
+	blocks_count = 0;
+	max_blocks   = 0;
+	next_block   = 0;
+	next_output  = 0;
+	stop         = false;
+	points       = 0;
+	errors       = 0;
+	compiled     = false;
+}
+
+
+Tabulation::~Tabulation()
+{
+	DeleteWorkers();
+}
+
+
+void Tabulation::SetThreads(unsigned int pthreads)
+{
+	threads = pthreads;
+}
+
+
+void Tabulation::SetStopObject(const volatile ttmath::StopCalculating * pstop_object)
+{
+	stop_object = pstop_object;
+}
+
+
+unsigned long Tabulation::Points() const
+{
+	return points;
+}
+
+
+unsigned long Tabulation::Errors() const
+{
+	return errors;
+}
+
+
+bool Tabulation::Compiled() const
+{
+	return compiled;
+}
+
+
+bool Tabulation::WasStopSignal()
+{
+	return stop_object && stop_object->WasStopSignal();
+}
+
+
+ttmath::ErrorCode Tabulation::Run(const char * expression, const char * variable,
+								  const char * start, const char * step, unsigned long pcount,
+								  const EvaluatorSettings & settings,
+								  const ttmath::Objects & variables,
+								  const ttmath::Objects & functions,
+								  Languages * languages,
+								  TabulationOutput & output)
+{
+	count        = pcount;
+	blocks_count = (count + block_points - 1) / block_points;
+	points       = 0;
+	errors       = 0;
+	compiled     = false;
+
+	std::vector<TabulationAxis> axes(1);
+	axes[0].variable = variable;
+	axes[0].start    = start;
+	axes[0].step     = step;
+	axes[0].count    = count;
+
+	unsigned int threads_count = (threads == 0) ? HowManyProcessors() : threads;
+
+	if( threads_count > blocks_count )
+		threads_count = (unsigned int)blocks_count;
+
+	if( threads_count == 0 )
+		threads_count = 1;
+
+	// each worker gets its own copy of the settings, tables and the compiled expression
+	for(unsigned int i=0 ; i<threads_count ; ++i)
+	{
+		Worker * worker     = new Worker();
+		worker->tabulation  = this;
+		worker->calc        = CreateTabulationWorker(settings.precision);
+		workers.push_back(worker);
+
+		worker->calc->SetStopObject(stop_object);
+		ttmath::ErrorCode code = worker->calc->Init(expression, axes, settings, variables, functions, languages);
+
+		if( code != ttmath::err_ok )
+		{
+			DeleteWorkers();
+			return code;
+		}
+	}
+
+	compiled = workers[0]->calc->Compiled();
+
+	if( workers.size() == 1 )
+		RunOneThread(*workers[0]->calc, output);
+	else
+		RunThreads(output);
+
+	DeleteWorkers();
+
+	if( points < count )
+		return ttmath::err_interrupt;
+
+return ttmath::err_ok;
+}
+
+
+void Tabulation::RunOneThread(TabulationWorkerBase & calc, TabulationOutput & output)
+{
+TabulationWorkerBase::Row row;
+
+	stop = false;
+
+	for(unsigned long i=0 ; i<count && !stop ; ++i)
+	{
+		if( WasStopSignal() )
+		{
+			stop = true;
+			break;
+		}
+
+		calc.Calculate(&i, row);
+
+		if( row.code != ttmath::err_ok )
+			++errors;
+
+		++points;
+
+		if( !output.Put(row.x[0], row.value, row.code) )
+			stop = true;
+	}
+}
+
+
+/*!
+	the workers take blocks in the ascending order and the finished blocks are put
+	to the output by this thread (in the same order), a worker cannot take a block
+	which is 'max_blocks' ahead of the output
+*/
+void Tabulation::RunThreads(TabulationOutput & output)
+{
+std::map<unsigned long, Block*>::iterator i;
+
+	stop        = false;
+	next_block  = 0;
+	next_output = 0;
+	max_blocks  = workers.size() * blocks_per_thread;
+
+	for(size_t w=0 ; w<workers.size() ; ++w)
+	{
+		if( !StartThread(workers[w]->thread, WorkerThread, workers[w]) )
+		{
+			// the rest is calculated by the started workers
+			for(size_t d=w ; d<workers.size() ; ++d)
+			{
+				delete workers[d]->calc;
+				delete workers[d];
+			}
+
+			workers.resize(w);
+			break;
+		}
+	}
+
+	if( workers.empty() )
+	{
+		stop = true;
+		return;
+	}
+
+	mutex.Lock();
+
+	while( next_output < blocks_count && !stop )
+	{
+		while( (i = finished.find(next_output)) == finished.end() && !stop )
+			result_cond.Wait(mutex);
+
+		if( i == finished.end() )
+			break;
+
+		Block * block = i->second;
+		finished.erase(i);
+		++next_output;
+		work_cond.Broadcast();
+		mutex.Unlock();
+
+		// the output is called without the lock
+		bool cont = PutBlock(*block, output);
+		delete block;
+
+		mutex.Lock();
+
+		if( !cont )
+		{
+			stop = true;
+			work_cond.Broadcast();
+		}
+	}
+
+	stop = true;
+	work_cond.Broadcast();
+	mutex.Unlock();
+
+	JoinWorkers();
+}
+
+
+bool Tabulation::PutBlock(const Block & block, TabulationOutput & output)
+{
+	for(unsigned long i=0 ; i<block.size ; ++i)
+	{
+		const TabulationWorkerBase::Row & row = block.rows[i];
+
+		if( row.code != ttmath::err_ok )
+			++errors;
+
+		++points;
+
+		if( !output.Put(row.x[0], row.value, row.code) )
+			return false;
+	}
+
+	// a stopped worker gives a shorter block
+	return block.size == block.rows.size() && !WasStopSignal();
+}
+
+
+void * Tabulation::WorkerThread(void * arg)
+{
+	Worker * worker = reinterpret_cast<Worker*>(arg);
+	worker->tabulation->WorkerLoop(*worker);
+
+return 0;
+}
+
+
+void Tabulation::WorkerLoop(Worker & worker)
+{
+	mutex.Lock();
+
+	while( true )
+	{
+		while( !stop && next_block < blocks_count && next_block >= next_output + max_blocks )
+			work_cond.Wait(mutex);
+
+		if( stop || next_block >= blocks_count )
+			break;
+
+		Block * block = new Block();
+		block->first  = (next_block++) * block_points;
+		block->size   = 0;
+		unsigned long seq = block->first / block_points;
+		mutex.Unlock();
+
+		// calculating without the lock
+		unsigned long size = count - block->first;
+
+		if( size > block_points )
+			size = block_points;
+
+		block->rows.resize(size);
+
+		while( block->size < size && !WasStopSignal() )
+		{
+			unsigned long index = block->first + block->size;
+			worker.calc->Calculate(&index, block->rows[block->size]);
+			++block->size;
+		}
+
+		mutex.Lock();
+		finished[seq] = block;
+		result_cond.Signal();
+	}
+
+	mutex.Unlock();
+}
+
+
+void Tabulation::JoinWorkers()
+{
+	for(size_t i=0 ; i<workers.size() ; ++i)
+		JoinThread(workers[i]->thread);
+
+	// blocks which were finished after the output had stopped
+	std::map<unsigned long, Block*>::iterator i = finished.begin();
+
+	for( ; i != finished.end() ; ++i)
+		delete i->second;
+
+	finished.clear();
+}
+
+
+void Tabulation::DeleteWorkers()
+{
+	for(size_t i=0 ; i<workers.size() ; ++i)
+	{
+		delete workers[i]->calc;
+		delete workers[i];
+	}
+
+	workers.clear();
+}
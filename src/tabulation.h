@@ -0,0 +1,322 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef headerfiletabulation
+#define headerfiletabulation
+
+/*!
+	\file tabulation.h
+    \brief calculating an expression for many values of one variable
+*/
+
+#include "compileconfig.h"
+#include "evaluator.h"
+#include "threads.h"
+
+#include <ttmath/ttmathobjects.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <ostream>
+
+
+/*!
+	\brief it receives the rows of a tabulation
+
+	rows are given in the order of x and always from the thread which has called
+	Tabulation::Run() so an object of this class doesn't have to be thread-safe
+*/
+class TabulationOutput
+{
+public:
+
+	virtual ~TabulationOutput() {}
+
+	/*!
+		one row: the printed x and the printed value of the expression
+		(or the message of an error if 'code' is not err_ok),
+		returning false stops the tabulation
+	*/
+	virtual bool Put(const std::string & x, const std::string & value, ttmath::ErrorCode code) = 0;
+};
+
+
+
+/*!
+	the default separator of CSV fields: a semicolon if the decimal point
+	of the output is a comma, otherwise a comma
+*/
+char CsvSeparator(const EvaluatorSettings & settings);
+
+
+/*!
+	appending one field to a CSV (or TSV) line,
+	the field is put in quotes when it has the separator, a quote or a new line
+*/
+void AppendCsvField(std::string & line, const std::string & field, char separator);
+
+
+
+/*!
+	\brief writing rows as lines of a CSV file: x, value
+*/
+class TabulationCsvOutput : public TabulationOutput
+{
+public:
+
+	TabulationCsvOutput(std::ostream & out, const EvaluatorSettings & settings);
+
+	/*!
+		changing the separator (e.g. to a tabulator for TSV files)
+	*/
+	void SetSeparator(char separator);
+
+	/*!
+		the first line with names of the columns
+	*/
+	void PutHeader(const std::string & variable, const std::string & expression);
+
+	bool Put(const std::string & x, const std::string & value, ttmath::ErrorCode code);
+
+
+private:
+
+	std::ostream & out;
+	char separator;
+	std::string line;
+};
+
+
+
+/*!
+	\brief one variable of a tabulation: variable = start + i * step, i = 0 .. count-1
+
+	start and step are expressions (they are calculated once)
+*/
+struct TabulationAxis
+{
+	std::string variable;
+	std::string start;
+	std::string step;
+	unsigned long count;
+};
+
+
+
+/*!
+	\brief the base class for workers of a tabulation (and of a sweep)
+
+	there is one worker for each thread, it has its own copy of the compiled expression
+	(or its own parser if the expression could not be compiled),
+	the objects are created by CreateTabulationWorker()
+*/
+class TabulationWorkerBase
+{
+public:
+
+	struct Row
+	{
+		std::vector<std::string> x;		// printed values of the variables (one for each axis)
+		std::string value;
+		ttmath::ErrorCode code;
+	};
+
+	virtual ~TabulationWorkerBase() {}
+
+	/*!
+		returning an error if a name is incorrect or used twice or if start or step
+		of an axis could not be calculated (count of the axes is not used here)
+	*/
+	virtual ttmath::ErrorCode Init(const char * expression,
+								   const std::vector<TabulationAxis> & axes,
+								   const EvaluatorSettings & settings,
+								   const ttmath::Objects & variables,
+								   const ttmath::Objects & functions,
+								   Languages * languages) = 0;
+
+	virtual void SetStopObject(const volatile ttmath::StopCalculating * stop_object) = 0;
+
+	/*!
+		calculating the row for the point given by indices (one for each axis):
+		variable[k] = start[k] + index[k] * step[k]
+	*/
+	virtual void Calculate(const unsigned long * index, Row & row) = 0;
+
+	/*!
+		true if the compiled form is used (the parser is used otherwise)
+	*/
+	virtual bool Compiled() const = 0;
+};
+
+
+/*!
+	creating a worker for the given level of the precision ladder
+*/
+TabulationWorkerBase * CreateTabulationWorker(int level);
+
+
+
+/*!
+	\brief calculating an expression for x = start + i * step (i = 0 .. count-1)
+
+	x is a name given by the user, the expression is compiled once by each worker
+	(CompiledExpression) and then only evaluated for each point, if it cannot be compiled
+	then each worker uses its own parser (the variable is then changed in a copy
+	of the variables' table before each point)
+
+	points are calculated in blocks by a pool of threads and given to the output
+	in the order of x, only a limited number of blocks can be calculated ahead
+	of the output so the memory doesn't grow with 'count'
+
+	usage:
+		Tabulation tab;
+		tab.SetThreads(0);
+		code = tab.Run("sin(x)", "x", "0", "0.1", 100, settings, variables, functions, &languages, output);
+*/
+class Tabulation
+{
+public:
+
+	/*!
+		how many points there are in one block
+	*/
+	static const unsigned long block_points = 64;
+
+
+	/*!
+		how many blocks there can be for one thread (calculated or waiting for the output)
+	*/
+	static const size_t blocks_per_thread = 4;
+
+
+	Tabulation();
+	~Tabulation();
+
+
+	/*!
+		how many threads are used by Run(), zero means as many as processors (default: 1)
+	*/
+	void SetThreads(unsigned int threads);
+
+
+	/*!
+		the object is checked between points (and passed to the parsers)
+	*/
+	void SetStopObject(const volatile ttmath::StopCalculating * stop_object);
+
+
+	/*!
+		calculating the expression for 'count' points and giving them to the output
+
+		'start' and 'step' are expressions too (they are calculated once),
+		the settings, variables and functions are copied,
+		returning an error if the variable's name is incorrect or 'start' or 'step'
+		could not be calculated (no rows are given then) or err_interrupt if the tabulation
+		was stopped (by the stop object or by the output), errors of particular points
+		don't stop the tabulation - they are given to the output and counted
+	*/
+	ttmath::ErrorCode Run(const char * expression, const char * variable,
+						  const char * start, const char * step, unsigned long count,
+						  const EvaluatorSettings & settings,
+						  const ttmath::Objects & variables,
+						  const ttmath::Objects & functions,
+						  Languages * languages,
+						  TabulationOutput & output);
+
+
+	/*!
+		statistics of the last Run()
+	*/
+	unsigned long Points() const;
+	unsigned long Errors() const;
+	bool Compiled() const;
+
+
+private:
+
+	struct Block
+	{
+		unsigned long first;
+		unsigned long size;
+		std::vector<TabulationWorkerBase::Row> rows;
+	};
+
+	struct Worker
+	{
+		Tabulation * tabulation;
+		pthread_t thread;
+		TabulationWorkerBase * calc;
+	};
+
+	unsigned int threads;
+	const volatile ttmath::StopCalculating * stop_object;
+
+	std::vector<Worker*> workers;
+	unsigned long count;
+	unsigned long blocks_count;
+	size_t max_blocks;
+
+	// the reorder buffer: finished blocks waiting for the output
+	std::map<unsigned long, Block*> finished;
+
+	unsigned long next_block;	// the number of the block which should be taken by a worker
+	unsigned long next_output;	// the number of the block which should be given to the output
+	bool stop;
+
+	unsigned long points, errors;
+	bool compiled;
+
+	Mutex mutex;
+	Condition work_cond;		// signaled when the output has taken a block (or stop)
+	Condition result_cond;		// signaled when a block is finished (or stop)
+
+	void RunOneThread(TabulationWorkerBase & calc, TabulationOutput & output);
+	void RunThreads(TabulationOutput & output);
+	bool PutBlock(const Block & block, TabulationOutput & output);
+	bool WasStopSignal();
+	void JoinWorkers();
+	void DeleteWorkers();
+
+	static void * WorkerThread(void * arg);
+	void WorkerLoop(Worker & worker);
+
+	Tabulation(const Tabulation &);
+	Tabulation & operator=(const Tabulation &);
+};
+
+
+#endif
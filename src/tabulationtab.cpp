@@ -0,0 +1,386 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "compileconfig.h"
+#include "tabs.h"
+#include "tabulation.h"
+#include "stopflag.h"
+
+#include <process.h>
+#include <fstream>
+#include <cstdlib>
+
+
+namespace TabWindowFunctions
+{
+namespace TabulationTab
+{
+
+/*!
+	the job is prepared by the gui thread and then only the tabulation thread
+	uses it until WM_TABULATION_FINISHED is posted (only one job can run at a time)
+*/
+struct Job
+{
+	std::string expression;
+	std::string variable;
+	std::string start;
+	std::string step;
+	unsigned long count;
+
+	EvaluatorSettings settings;
+	ObjectsSnapshot variables;
+	ObjectsSnapshot functions;
+	Languages * languages;
+
+	// if empty the result is shown in the edit
+	std::string file_name;
+
+	std::string text;
+	ttmath::ErrorCode code;
+	bool file_error;
+};
+
+
+Job job;
+HANDLE thread   = 0;
+HWND tab_dialog = 0;
+StopFlag stop;
+bool truncated;
+
+
+// how many rows can be shown in the edit (all of them can be saved to a file)
+const unsigned long max_shown_rows = 10000;
+
+
+
+/*!
+	rows for the edit: x and the value separated by a tabulator
+*/
+class EditOutput : public TabulationOutput
+{
+public:
+
+	EditOutput(std::string & ptext) : text(ptext)
+	{
+	}
+
+	bool Put(const std::string & x, const std::string & value, ttmath::ErrorCode)
+	{
+		text += x;
+		text += '\t';
+		text += value;
+		text += "\r\n";
+
+	return true;
+	}
+
+private:
+
+	std::string & text;
+};
+
+
+
+unsigned __stdcall TabulationProc(void *)
+{
+Tabulation tabulation;
+
+	tabulation.SetThreads(0);
+	tabulation.SetStopObject(&stop);
+
+	if( job.file_name.empty() )
+	{
+		EditOutput output(job.text);
+
+		job.code = tabulation.Run(job.expression.c_str(), job.variable.c_str(), job.start.c_str(),
+								  job.step.c_str(), job.count, job.settings, *job.variables.Get(),
+								  *job.functions.Get(), job.languages, output);
+	}
+	else
+	{
+		std::ofstream file(job.file_name.c_str(), std::ios_base::out | std::ios_base::binary);
+
+		if( file )
+		{
+			TabulationCsvOutput output(file, job.settings);
+			output.PutHeader(job.variable, job.expression);
+
+			job.code = tabulation.Run(job.expression.c_str(), job.variable.c_str(), job.start.c_str(),
+									  job.step.c_str(), job.count, job.settings, *job.variables.Get(),
+									  *job.functions.Get(), job.languages, output);
+
+			file.close();
+		}
+
+		job.file_error = !file;
+	}
+
+	PostMessage(tab_dialog, WM_TABULATION_FINISHED, 0, 0);
+
+return 0;
+}
+
+
+void GetText(HWND hWnd, int id, std::string & text)
+{
+	HWND edit = GetDlgItem(hWnd, id);
+	int len   = GetWindowTextLength(edit);
+
+	text.resize(len + 1);
+	GetWindowText(edit, &text[0], len + 1);
+	text.resize(len);
+}
+
+
+bool SaveDialog(HWND hwnd, std::string & file_name)
+{
+OPENFILENAME o;
+char buf[MAX_PATH];
+
+	sprintf(buf, "ttcalc.csv");
+
+	o.lStructSize       = sizeof(o);
+	o.hwndOwner         = hwnd;
+	o.hInstance         = GetPrgRes()->GetInstance();
+	o.lpstrFilter       = "*.csv\0*.csv\0*.*\0*.*\0";
+	o.lpstrCustomFilter = 0;
+	o.nMaxCustFilter    = 0;
+	o.nFilterIndex      = 1;
+	o.lpstrFile         = buf;
+	o.nMaxFile          = MAX_PATH;
+	o.lpstrFileTitle    = 0;
+	o.nMaxFileTitle     = 0;
+	o.lpstrInitialDir   = 0;
+	o.lpstrTitle        = 0;
+	o.Flags             = OFN_OVERWRITEPROMPT | OFN_PATHMUSTEXIST;
+	o.nFileOffset       = 0;
+	o.nFileExtension    = 0;
+	o.lpstrDefExt       = "csv";
+	o.lCustData         = 0;
+	o.lpfnHook          = 0;
+	o.lpTemplateName    = 0;
+
+	if( GetSaveFileName(&o) )
+	{
+		file_name = buf;
+		return true;
+	}
+
+return false;
+}
+
+
+void SetButtons(HWND hWnd)
+{
+	Languages::GuiMsg tabulate = thread ? Languages::tabulation_stop : Languages::tabulation_calculate;
+
+	SetDlgItemText(hWnd, IDC_BUTTON_TABULATE, GetPrgRes()->GetLanguages()->GuiMessage(tabulate));
+	EnableWindow(GetDlgItem(hWnd, IDC_BUTTON_TABULATION_SAVE), thread == 0);
+}
+
+
+/*!
+	the expression is taken from the main input,
+	the settings are copied (we're in the gui thread), variables and functions
+	are taken as snapshots so the job sees them unchanged
+*/
+void StartJob(HWND hWnd, const std::string & file_name)
+{
+std::string count;
+unsigned int thread_id;
+
+	GetText(GetPrgRes()->GetMainWindow(), IDC_INPUT_EDIT, job.expression);
+	GetText(hWnd, IDC_EDIT_TABULATION_VARIABLE, job.variable);
+	GetText(hWnd, IDC_EDIT_TABULATION_START, job.start);
+	GetText(hWnd, IDC_EDIT_TABULATION_STEP, job.step);
+	GetText(hWnd, IDC_EDIT_TABULATION_COUNT, count);
+
+	job.count      = strtoul(count.c_str(), 0, 10);
+	job.variables  = GetPrgRes()->GetVariablesSnapshot();
+	job.functions  = GetPrgRes()->GetFunctionsSnapshot();
+	job.languages  = GetPrgRes()->GetLanguages();
+	job.file_name  = file_name;
+	job.code       = ttmath::err_ok;
+	job.file_error = false;
+	job.text.clear();
+	GetPrgRes()->GetEvaluatorSettings(job.settings);
+
+	truncated = file_name.empty() && job.count > max_shown_rows;
+
+	if( truncated )
+		job.count = max_shown_rows;
+
+	SetDlgItemText(hWnd, IDC_EDIT_TABULATION_RESULT, "");
+	tab_dialog = hWnd;
+	stop.Start();
+
+	thread = (HANDLE)_beginthreadex(0, 0, TabulationProc, 0, 0, &thread_id);
+
+	if( !thread )
+	{
+		Languages * lang = GetPrgRes()->GetLanguages();
+		MessageBox(hWnd, lang->GuiMessage(Languages::cant_create_thread),
+						 lang->GuiMessage(Languages::message_box_error_caption), MB_ICONERROR);
+	}
+
+	SetButtons(hWnd);
+}
+
+
+/*!
+	the button is 'stop' when the tabulation is running
+*/
+BOOL WmTabCommand_Tabulate(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+	if( thread )
+		stop.Stop();
+	else
+		StartJob(hWnd, std::string());
+
+return true;
+}
+
+
+BOOL WmTabCommand_Save(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+std::string file_name;
+
+	if( !thread && SaveDialog(hWnd, file_name) )
+		StartJob(hWnd, file_name);
+
+return true;
+}
+
+
+BOOL WmTabulationFinished(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+	if( !thread )
+		return true;
+
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+	thread = 0;
+
+	// the gui can change variables and functions without copying them now
+	job.variables.Reset();
+	job.functions.Reset();
+
+	Languages * lang = GetPrgRes()->GetLanguages();
+
+	if( job.code == ttmath::err_ok && truncated )
+		job.text += "...\r\n";
+
+	if( job.code != ttmath::err_ok && job.code != ttmath::err_interrupt )
+	{
+		job.text += lang->ErrorMessage(job.settings.country, job.code);
+		job.text += "\r\n";
+	}
+
+	if( job.file_error )
+		MessageBox(hWnd, lang->GuiMessage(Languages::cannot_save_file),
+						 lang->GuiMessage(Languages::message_box_error_caption), MB_ICONERROR);
+
+	SetDlgItemText(hWnd, IDC_EDIT_TABULATION_RESULT, job.text.c_str());
+	job.text.clear();
+	SetButtons(hWnd);
+
+return true;
+}
+
+
+BOOL WmInitTabTabulation(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+	SetDlgItemText(hWnd, IDC_EDIT_TABULATION_VARIABLE, "x");
+	SetDlgItemText(hWnd, IDC_EDIT_TABULATION_START, "0");
+	SetDlgItemText(hWnd, IDC_EDIT_TABULATION_STEP, "1");
+	SetDlgItemText(hWnd, IDC_EDIT_TABULATION_COUNT, "10");
+
+return true;
+}
+
+
+void SetLanguage(HWND hWnd)
+{
+Languages * lang = GetPrgRes()->GetLanguages();
+
+	SetDlgItemText(hWnd, IDC_LABEL_TABULATION_VARIABLE, lang->GuiMessage(Languages::tabulation_variable));
+	SetDlgItemText(hWnd, IDC_LABEL_TABULATION_START, lang->GuiMessage(Languages::tabulation_start));
+	SetDlgItemText(hWnd, IDC_LABEL_TABULATION_STEP, lang->GuiMessage(Languages::tabulation_step));
+	SetDlgItemText(hWnd, IDC_LABEL_TABULATION_COUNT, lang->GuiMessage(Languages::tabulation_count));
+	SetDlgItemText(hWnd, IDC_BUTTON_TABULATION_SAVE, lang->GuiMessage(Languages::tabulation_save));
+
+	SetButtons(hWnd);
+}
+
+
+void SetSizeOfResult(HWND tab, int tabx, int taby, int borderx, int bordery)
+{
+RECT r;
+POINT p;
+
+	HWND dialog = GetPrgRes()->GetTabWindow(tab_tabulation);
+	HWND result = GetDlgItem(dialog, IDC_EDIT_TABULATION_RESULT);
+	int resize_flags = SWP_NOMOVE | SWP_NOZORDER | SWP_NOACTIVATE | SWP_NOOWNERZORDER;
+
+	ResizeTabDialog(tab, dialog, tabx, taby, borderx, bordery);
+
+	GetWindowRect(result, &r);
+	p.x = r.left;
+	p.y = r.top;
+	ScreenToClient(tab, &p);
+	SetWindowPos(result, 0, 0, 0, tabx - borderx - p.x, taby - bordery - p.y, resize_flags);
+}
+
+
+/*!
+	called when the program is closing
+*/
+void StopThread()
+{
+	if( !thread )
+		return;
+
+	stop.Stop();
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+	thread = 0;
+}
+
+
+} // namespace
+} // namespace
@@ -0,0 +1,240 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "compileconfig.h"
+#include "textfile.h"
+
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+
+
+
+TextFile::TextFile()
+{
+	data = 0;
+	size = 0;
+
+	#ifdef _WIN32
+	file    = INVALID_HANDLE_VALUE;
+	mapping = 0;
+	#else
+	file    = -1;
+	#endif
+}
+
+
+TextFile::~TextFile()
+{
+	Close();
+}
+
+
+#ifdef _WIN32
+
+bool TextFile::Open(const char * file_name)
+{
+	Close();
+
+	file = CreateFileA(file_name, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING,
+					   FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, 0);
+
+	if( file == INVALID_HANDLE_VALUE )
+		return false;
+
+	DWORD high;
+	DWORD low = GetFileSize(file, &high);
+
+	if( (low == INVALID_FILE_SIZE && GetLastError() != NO_ERROR) || (sizeof(size_t) < 8 && high != 0) )
+	{
+		Close();
+		return false;
+	}
+
+	ULARGE_INTEGER file_size;
+	file_size.LowPart  = low;
+	file_size.HighPart = high;
+	size = (size_t)file_size.QuadPart;
+
+	// an empty file cannot be mapped
+	if( size == 0 )
+		return true;
+
+	mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+
+	if( mapping )
+		data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+	if( !data )
+	{
+		Close();
+		return false;
+	}
+
+return true;
+}
+
+
+void TextFile::Close()
+{
+	if( data )
+		UnmapViewOfFile(data);
+
+	if( mapping )
+		CloseHandle(mapping);
+
+	if( file != INVALID_HANDLE_VALUE )
+		CloseHandle(file);
+
+	data    = 0;
+	size    = 0;
+	mapping = 0;
+	file    = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+bool TextFile::Open(const char * file_name)
+{
+struct stat info;
+
+	Close();
+	file = open(file_name, O_RDONLY);
+
+	if( file == -1 )
+		return false;
+
+	if( fstat(file, &info) != 0 )
+	{
+		Close();
+		return false;
+	}
+
+	size = (size_t)info.st_size;
+
+	// an empty file cannot be mapped
+	if( size == 0 )
+		return true;
+
+	void * p = mmap(0, size, PROT_READ, MAP_PRIVATE, file, 0);
+
+	if( p == MAP_FAILED )
+	{
+		Close();
+		return false;
+	}
+
+	data = (const char*)p;
+	madvise(p, size, MADV_SEQUENTIAL);
+
+return true;
+}
+
+
+void TextFile::Close()
+{
+	if( data )
+		munmap(const_cast<char*>(data), size);
+
+	if( file != -1 )
+		close(file);
+
+	data = 0;
+	size = 0;
+	file = -1;
+}
+
+#endif
+
+
+size_t TextFile::Size() const
+{
+	return size;
+}
+
+
+const char * TextFile::Data() const
+{
+	return data;
+}
+
+
+void TextFile::Read(std::string & text, const char * new_line) const
+{
+	ChangeNewLines(data, size, text, new_line);
+}
+
+
+/*!
+	the first pass counts new lines so the text is allocated only once,
+	the second one copies runs of characters between them
+*/
+void TextFile::ChangeNewLines(const char * data, size_t size, std::string & text, const char * new_line)
+{
+size_t new_line_len = strlen(new_line);
+size_t lines = 0, i, start;
+
+	text.clear();
+
+	for(i=0 ; i<size ; ++i)
+		if( data[i] == '\n' || (data[i] == '\r' && (i+1 == size || data[i+1] != '\n')) )
+			++lines;
+
+	text.reserve(size + lines * new_line_len);
+
+	for(i=0, start=0 ; i<size ; ++i)
+	{
+		if( data[i] != '\r' && data[i] != '\n' )
+			continue;
+
+		text.append(data + start, i - start);
+		text.append(new_line, new_line_len);
+
+		if( data[i] == '\r' && i+1 < size && data[i+1] == '\n' )
+			++i;
+
+		start = i + 1;
+	}
+
+	text.append(data + start, size - start);
+}
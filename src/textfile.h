@@ -0,0 +1,127 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef headerfiletextfile
+#define headerfiletextfile
+
+/*!
+	\file textfile.h
+    \brief reading text files (mapped into memory) with changing new lines
+*/
+
+#include "compileconfig.h"
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+
+/*!
+	\brief a text file mapped into memory (read only)
+
+	the file is not copied by Open(), Read() makes one pass through the mapped
+	memory and copies the text in runs between new line characters, all kinds
+	of new lines ("\r\n", "\n" and "\r") are changed into the given one
+
+	usage:
+		TextFile file;
+
+		if( file.Open("sheet.txt") && file.Size() < max_size )
+			file.Read(text, "\r\n");
+*/
+class TextFile
+{
+public:
+
+	TextFile();
+	~TextFile();
+
+
+	/*!
+		mapping the file, returning false if it cannot be opened
+	*/
+	bool Open(const char * file_name);
+
+
+	/*!
+		unmapping the file
+	*/
+	void Close();
+
+
+	/*!
+		the size of the file in bytes (before changing new lines)
+	*/
+	size_t Size() const;
+
+
+	/*!
+		the content of the file (not terminated by a zero)
+	*/
+	const char * Data() const;
+
+
+	/*!
+		copying the content to 'text' with new lines changed into 'new_line'
+	*/
+	void Read(std::string & text, const char * new_line) const;
+
+
+	/*!
+		the same for a text in memory
+	*/
+	static void ChangeNewLines(const char * data, size_t size, std::string & text, const char * new_line);
+
+
+private:
+
+	const char * data;
+	size_t size;
+
+	#ifdef _WIN32
+	HANDLE file, mapping;
+	#else
+	int file;
+	#endif
+
+	TextFile(const TextFile &);
+	TextFile & operator=(const TextFile &);
+};
+
+
+#endif
@@ -40,18 +40,68 @@
 
 
 
+CalculationStatistics::CalculationStatistics()
+{
+	started   = 0;
+	completed = 0;
+	cancelled = 0;
+	discarded = 0;
+	time      = GetTickCount();
+}
+
+
+void CalculationStatistics::PerSecond(const CalculationStatistics & older,
+									  double & started_ps, double & completed_ps,
+									  double & cancelled_ps, double & discarded_ps) const
+{
+	// unsigned arithmetic works even if GetTickCount() has wrapped around
+	double seconds = double(time - older.time) / 1000.0;
+
+	if( seconds <= 0.0 )
+	{
+		started_ps = completed_ps = cancelled_ps = discarded_ps = 0.0;
+		return;
+	}
+
+	started_ps   = double(started   - older.started)   / seconds;
+	completed_ps = double(completed - older.completed) / seconds;
+	cancelled_ps = double(cancelled - older.cancelled) / seconds;
+	discarded_ps = double(discarded - older.discarded) / seconds;
+}
+
+
+
+
 ThreadController::ThreadController()
 {
-	calculations   = 0;
-	ready_for_stop = 0;
-	exit_thread    = false;
+	calculations = 0;
+	mailbox      = 0;
+	mailbox_full = false;
+	initialized  = false;
+	exit_thread  = false;
+
+	generation          = 0;
+	job_generation      = 0;
+	last_job_generation = (unsigned long)-1; // the first job is always made
+
+	started   = 0;
+	completed = 0;
+	cancelled = 0;
+	discarded = 0;
 }
 
 
 ThreadController::~ThreadController()
 {
-	if(calculations)   CloseHandle(calculations);
-	if(ready_for_stop) CloseHandle(ready_for_stop);
+	if(calculations) CloseHandle(calculations);
+
+	if( initialized )
+	{
+		DeleteCriticalSection(&copy_lock);
+		DeleteCriticalSection(&mailbox_lock);
+	}
+
+	delete [] mailbox;
 }
 
 
@@ -71,62 +121,195 @@ bool ThreadController::Init() volatile
 		return false;
 	}
 
-	sprintf((char*)buffer,"TTCalcEventReadyForStop5567%u",
-													(unsigned int)GetTickCount());
+	delete [] buffer;
 
-	// 'ready_for_stop' will be for manual-reseting and initialized as signaled
-	// 'manual-reset' means that we must call ResetEvent() function (from WinAPI)
-	// to manually reset the state to nonsignaled
-	if( (ready_for_stop = CreateEvent(0,true,true,(char*)buffer))==NULL)
-	{
-		delete [] buffer;
-		return false;
-	}
+	InitializeCriticalSection(const_cast<CRITICAL_SECTION*>(&copy_lock));
+	InitializeCriticalSection(const_cast<CRITICAL_SECTION*>(&mailbox_lock));
+	initialized = true;
 
-	delete [] buffer;
+	mailbox = new char[input_size];
+	mailbox[0] = 0;
 
 return stop_calculating.Init();
 }
 
 
+void ThreadController::Lock(volatile CRITICAL_SECTION & section)
+{
+	EnterCriticalSection(const_cast<CRITICAL_SECTION*>(&section));
+}
+
+
+void ThreadController::Unlock(volatile CRITICAL_SECTION & section)
+{
+	LeaveCriticalSection(const_cast<CRITICAL_SECTION*>(&section));
+}
+
+
 void ThreadController::ReadyForStop() volatile
 {
-	SetEvent( ready_for_stop );
+	Unlock(copy_lock);
 }
 
 
 void ThreadController::StopCalculatingAndExitThread() volatile
 {
-	WaitForSingleObject(ready_for_stop,INFINITE);
+	Lock(copy_lock);
 
 	stop_calculating.Stop();
 	exit_thread = true;
+
+	Unlock(copy_lock);
 	SetEvent(calculations);
 }
 
 
-void ThreadController::StopCalculating() volatile
+void ThreadController::StopCalculating(bool stop_parsing) volatile
 {
-	WaitForSingleObject(ready_for_stop, INFINITE);
+	// we're waiting if the second thread is copying variables
+	// and then the second thread cannot start copying until StartCalculating()
+	Lock(copy_lock);
 
-	stop_calculating.Stop();
+	if( stop_parsing )
+		stop_calculating.Stop();
 }
 
 
 void ThreadController::StartCalculating() volatile
 {
+	++generation;
+	Unlock(copy_lock);
+	SetEvent(calculations);
+}
+
+
+void ThreadController::PostInput(const char * input) volatile
+{
+unsigned int i;
+
+	Lock(mailbox_lock);
+
+	for(i=0 ; i<input_size-1 && input[i]!=0 ; ++i)
+		mailbox[i] = input[i];
+
+	mailbox[i]   = 0;
+	mailbox_full = true;
+	++generation;
+
+	Unlock(mailbox_lock);
+
+	stop_calculating.Stop();
 	SetEvent(calculations);
 }
 
 
+bool ThreadController::TakeInput(char * & buffer) volatile
+{
+bool taken = false;
+
+	Lock(mailbox_lock);
+
+	if( mailbox_full )
+	{
+		char * old = buffer;
+		buffer     = mailbox;
+		mailbox    = old;
+
+		mailbox_full = false;
+		taken        = true;
+	}
+
+	// we're in the copying time so StartCalculating() cannot change it now
+	// and PostInput() changes it only with the mailbox locked
+	job_generation = generation;
+
+	Unlock(mailbox_lock);
+
+return taken;
+}
+
+
+unsigned long ThreadController::GetGeneration() volatile const
+{
+	return generation;
+}
+
+
+unsigned long ThreadController::GetJobGeneration() volatile const
+{
+	return job_generation;
+}
+
+
+bool ThreadController::IsNewJob() volatile const
+{
+	return job_generation != last_job_generation;
+}
+
+
+void ThreadController::JobDone() volatile
+{
+	last_job_generation = job_generation;
+}
+
+
+bool ThreadController::IsJobStale() volatile const
+{
+	return generation != job_generation;
+}
+
+
+void ThreadController::CountJob(JobEvent job_event) volatile
+{
+	switch( job_event )
+	{
+	case job_started:
+		++started;
+		break;
+
+	case job_completed:
+		++completed;
+		break;
+
+	case job_cancelled:
+		++cancelled;
+		break;
+
+	default:
+		++discarded;
+		break;
+	}
+}
+
+
+void ThreadController::GetStatistics(CalculationStatistics & statistics) volatile const
+{
+	// the counters are only read here (aligned longs are read atomically)
+	statistics.started   = started;
+	statistics.completed = completed;
+	statistics.cancelled = cancelled;
+	statistics.discarded = discarded;
+	statistics.time      = GetTickCount();
+}
+
+
 volatile bool ThreadController::WaitForCalculatingAndBlockForStop() volatile
 {
 	WaitForSingleObject(calculations,INFINITE);
-	ResetEvent(ready_for_stop);
+
+	// the first thread can be between StopCalculating() and StartCalculating()
+	// and we must not copy anything then
+	Lock(copy_lock);
+
+	if( exit_thread )
+	{
+		Unlock(copy_lock);
+		return false;
+	}
 
 	stop_calculating.Start();
 
-return !exit_thread;
+return true;
 }
 
 
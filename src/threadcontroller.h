@@ -45,7 +45,72 @@
 
 #include <ttmath/ttmathobjects.h>
 #include <windows.h>
+#include <string>
 #include "stopcalculating.h"
+#include "spscqueue.h"
+
+
+/*!
+	\brief statistics of the jobs done by the second thread
+
+	one job is one input string (or a change of settings), if the user is typing
+	quickly most of the jobs are cancelled during parsing or discarded before
+	parsing has started
+*/
+struct CalculationStatistics
+{
+	unsigned long started;		// parsing has started
+	unsigned long completed;	// parsing has finished (without a stop signal)
+	unsigned long cancelled;	// parsing was stopped because there was a newer job
+	unsigned long discarded;	// there was a newer job before parsing started
+
+	// GetTickCount() from the moment the statistics were taken
+	DWORD time;
+
+
+	CalculationStatistics();
+
+
+	/*!
+		how many jobs per second were started/completed/cancelled/discarded
+		between 'older' statistics and these ones
+	*/
+	void PerSecond(const CalculationStatistics & older,
+				   double & started_ps, double & completed_ps,
+				   double & cancelled_ps, double & discarded_ps) const;
+};
+
+
+
+/*!
+	\brief a result which the second thread gives to the gui
+
+	the second thread doesn't call SetDlgItemText() (it would be a synchronous
+	SendMessage to the gui thread), results are put into a queue (ResultQueue)
+	and the gui is informed by posting one WM_SET_RESULT message
+*/
+struct CalculationResult
+{
+	// the generation of the job (from ThreadController)
+	unsigned long generation;
+
+	// err_still_calculating if the calculations have just started
+	ttmath::ErrorCode code;
+
+	// the text for the output edit
+	std::string output;
+
+	// the text for the info on the converting tab
+	std::string convert_info;
+};
+
+
+/*!
+	the queue of results: the second thread is the producer and the gui is the consumer
+	(there're at most two results for one job so the queue doesn't have to be long)
+*/
+typedef SPSCQueue<CalculationResult, 8> ResultQueue;
+
 
 
 /*! 
@@ -64,13 +129,23 @@
 	there's only one object of this class in our application, we can get a pointer
 	to it by using GetPrgRes() function and then by GetThreadController() method
 
-	when we would like to change for example the input string first we must call
-	StopCalculating() method then we can change what we want to change and then
-	we must call StartCalculating(), for example if we wanted to change the precision
-	of displaying we'd have to do:
+	when we would like to change for example the precision, variables or functions
+	first we must call StopCalculating() method then we can change what we want to
+	change and then we must call StartCalculating(), for example if we wanted to
+	change the precision of displaying we'd have to do:
 		GetPrgRes()->GetThreadController()->StopCalculating();
 		GetPrgRes()->SetPrecision( ..new_precision.. );
 		GetPrgRes()->GetThreadController()->StartCalculating();
+
+	the input string is changed very often (with every key) so it's not passed
+	in this way, it is put into a mailbox instead (PostInput()) and the gui doesn't
+	wait for the second thread at all - if the second thread has not taken the input
+	yet then the newer input simply replaces the older one
+
+	each PostInput() and StartCalculating() begins a new generation, the second thread
+	remembers the generation of the job it has taken (TakeInput()) and doesn't parse
+	the job if a newer generation has come in the meantime (IsJobStale()), in this way
+	only the newest input is parsed when the user is typing quickly
 */
 class ThreadController
 {
@@ -89,10 +164,17 @@ public:
 	~ThreadController();
 
 
+	/*!
+		the size of the input buffers (the same as the size of the buffer in ProgramResources)
+	*/
+	static const unsigned int input_size = 20480;
+
+
 	/*!
 		it initializes an object of this class
 
-		we create two system event and initialize the 'stop_calculating' object
+		we create a system event, the critical sections, the mailbox for the input
+		and initialize the 'stop_calculating' object
 	*/
 	bool Init() volatile;
 
@@ -102,6 +184,9 @@ public:
 		then there's special time for making copy of certain objects (e.g. the input
 		string, user-defined variables, functions etc.) and when the second thread 
 		will have finished that then it call ReadyForStop() method
+
+		during that time the second thread holds 'copy_lock' so the first thread
+		cannot change anything (StopCalculating() waits for the lock)
 	*/
 	void ReadyForStop() volatile;
 
@@ -120,9 +205,13 @@ public:
 
 		StopCalculating() waits for the second thread (if it is in the special time
 		of copying variables) then sets the 'stop object' for signaled and returns to
-		the caller
+		the caller, the 'copy_lock' is held until StartCalculating() is called
+
+		if you change only settings of displaying (rounding, the output base etc.)
+		then pass false - the current parsing will not be interrupted and its values
+		will be printed again with the new settings (nothing is parsed again)
 	*/
-	void StopCalculating() volatile;
+	void StopCalculating(bool stop_parsing = true) volatile;
 
 
 	/*!
@@ -133,6 +222,88 @@ public:
 	void StartCalculating() volatile;
 
 
+	/*!
+		it's called from the first thread when the input string has changed
+
+		the string is copied to the mailbox (replacing an input which was not taken yet),
+		the current calculations are stopped and the new ones are started,
+		this method doesn't wait for the second thread
+	*/
+	void PostInput(const char * input) volatile;
+
+
+	/*!
+		it's called by the second thread in the special time of copying variables
+
+		if there is a new input in the mailbox the buffers are swapped: 'buffer' gets
+		the newest input and the old buffer is used for the next posting
+		(both buffers have 'input_size' characters)
+
+		it returns false if nothing new was posted (the buffer is not changed then)
+
+		the current generation becomes the generation of the job
+	*/
+	bool TakeInput(char * & buffer) volatile;
+
+
+	/*!
+		the current generation (the gui uses it to skip results which are too old)
+	*/
+	unsigned long GetGeneration() volatile const;
+
+
+	/*!
+		the generation of the job taken by the second thread
+	*/
+	unsigned long GetJobGeneration() volatile const;
+
+
+	/*!
+		it's called by the second thread after the copying variables
+
+		it returns false if the job has the same generation as the last finished job
+		(the second thread was woken up more than once for the same generation)
+		in such a case there's nothing to do
+	*/
+	bool IsNewJob() volatile const;
+
+
+	/*!
+		it's called by the second thread when the result of the job has been published,
+		a job which was not finished (e.g. it was stopped by PostInput() just before
+		TakeInput() took it) is parsed again when the thread is woken up
+	*/
+	void JobDone() volatile;
+
+
+	/*!
+		it returns true if the first thread has posted a newer input or changed
+		the settings after the current job was taken
+	*/
+	bool IsJobStale() volatile const;
+
+
+	enum JobEvent
+	{
+		job_started,
+		job_completed,
+		job_cancelled,
+		job_discarded
+	};
+
+
+	/*!
+		the second thread counts what has happened to the current job
+	*/
+	void CountJob(JobEvent job_event) volatile;
+
+
+	/*!
+		the statistics of jobs (it can be called from any thread)
+	*/
+	void GetStatistics(CalculationStatistics & statistics) volatile const;
+
+
 	/*!
 		this is the main method which is used by the second thread,
 		if there's nothing to do this method (and the second thread as well) waits
@@ -159,11 +330,29 @@ private:
 	// auto-reset, initialized as non-signaled
 	HANDLE calculations;
 
-	// manual-reset, initialized as signaled
-	HANDLE ready_for_stop;
+	// held by the second thread during copying variables
+	// and by the first thread between StopCalculating() and StartCalculating()
+	CRITICAL_SECTION copy_lock;
+
+	// the mailbox for the input string
+	CRITICAL_SECTION mailbox_lock;
+	char * mailbox;
+	bool mailbox_full;
 
+	bool initialized;
 	bool exit_thread;
 
+	// changed only by the first thread (in PostInput() and StartCalculating())
+	unsigned long generation;
+
+	// used only by the second thread
+	// (last_job_generation is the generation of the last finished job)
+	unsigned long job_generation;
+	unsigned long last_job_generation;
+
+	// changed only by the second thread
+	unsigned long started, completed, cancelled, discarded;
+
 	NewStopCalculating stop_calculating;
 
 
@@ -173,6 +362,10 @@ private:
 	*/
 	ThreadController(const ThreadController &);
 
+
+	static void Lock(volatile CRITICAL_SECTION & section);
+	static void Unlock(volatile CRITICAL_SECTION & section);
+
 };
 
 
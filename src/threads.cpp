@@ -0,0 +1,161 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "compileconfig.h"
+#include "threads.h"
+#include "bigtypes.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+
+#ifdef TTMATH_MULTITHREADS_HELPER
+// ttmath needs it when its static objects are used from more than one thread
+TTMATH_MULTITHREADS_HELPER
+#endif
+
+
+
+Mutex::Mutex()
+{
+	pthread_mutex_init(&mutex, 0);
+}
+
+
+Mutex::~Mutex()
+{
+	pthread_mutex_destroy(&mutex);
+}
+
+
+void Mutex::Lock()
+{
+	pthread_mutex_lock(&mutex);
+}
+
+
+void Mutex::Unlock()
+{
+	pthread_mutex_unlock(&mutex);
+}
+
+
+
+
+Condition::Condition()
+{
+	pthread_cond_init(&cond, 0);
+}
+
+
+Condition::~Condition()
+{
+	pthread_cond_destroy(&cond);
+}
+
+
+void Condition::Wait(Mutex & mutex)
+{
+	pthread_cond_wait(&cond, &mutex.mutex);
+}
+
+
+void Condition::Signal()
+{
+	pthread_cond_signal(&cond);
+}
+
+
+void Condition::Broadcast()
+{
+	pthread_cond_broadcast(&cond);
+}
+
+
+
+
+bool StartThread(pthread_t & thread, void * (*thread_function)(void*), void * arg)
+{
+	return pthread_create(&thread, 0, thread_function, arg) == 0;
+}
+
+
+void JoinThread(pthread_t & thread)
+{
+	pthread_join(thread, 0);
+}
+
+
+void SleepThread(unsigned int milliseconds)
+{
+#ifdef _WIN32
+
+	Sleep(milliseconds);
+
+#else
+
+	usleep(milliseconds * 1000);
+
+#endif
+}
+
+
+unsigned int HowManyProcessors()
+{
+long count;
+
+#ifdef _WIN32
+
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	count = (long)info.dwNumberOfProcessors;
+
+#else
+
+	count = sysconf(_SC_NPROCESSORS_ONLN);
+
+#endif
+
+	if( count < 1 )
+		count = 1;
+
+return (unsigned int)count;
+}
+
@@ -0,0 +1,159 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef headerfilethreads
+#define headerfilethreads
+
+/*!
+	\file threads.h
+    \brief simple wrappers for posix threads used by the evaluation core
+
+	the gui uses the win32 api directly (ThreadController) but the core
+	is built on linux as well so here we're using pthreads
+	(on windows they are provided by mingw)
+*/
+
+#include "compileconfig.h"
+#include <pthread.h>
+
+
+/*!
+	\brief a mutex
+*/
+class Mutex
+{
+public:
+
+	Mutex();
+	~Mutex();
+
+	void Lock();
+	void Unlock();
+
+private:
+
+	pthread_mutex_t mutex;
+
+	friend class Condition;
+
+	// it cannot be copied
+	Mutex(const Mutex &);
+	Mutex & operator=(const Mutex &);
+};
+
+
+
+/*!
+	\brief the mutex is locked in the constructor and unlocked in the destructor
+*/
+class MutexLock
+{
+public:
+
+	MutexLock(Mutex & m) : mutex(m)
+	{
+		mutex.Lock();
+	}
+
+	~MutexLock()
+	{
+		mutex.Unlock();
+	}
+
+private:
+
+	Mutex & mutex;
+
+	MutexLock(const MutexLock &);
+	MutexLock & operator=(const MutexLock &);
+};
+
+
+
+/*!
+	\brief a condition variable
+*/
+class Condition
+{
+public:
+
+	Condition();
+	~Condition();
+
+	/*!
+		the mutex must be locked by the caller
+	*/
+	void Wait(Mutex & mutex);
+
+	void Signal();
+	void Broadcast();
+
+private:
+
+	pthread_cond_t cond;
+
+	Condition(const Condition &);
+	Condition & operator=(const Condition &);
+};
+
+
+
+/*!
+	starting a new thread, returning false if it could not be created
+*/
+bool StartThread(pthread_t & thread, void * (*thread_function)(void*), void * arg);
+
+
+/*!
+	waiting for a thread to finish
+*/
+void JoinThread(pthread_t & thread);
+
+
+/*!
+	suspending the current thread
+*/
+void SleepThread(unsigned int milliseconds);
+
+
+/*!
+	returning the number of processors (at least one)
+*/
+unsigned int HowManyProcessors();
+
+
+#endif
@@ -167,42 +167,104 @@ const char * message;
 
 
 
-int AddNewItemToVariableList(HWND list, const std::string & name, const std::string & value)
+/*!
+	the rows of the virtual list of variables
+*/
+ObjectsList rows;
+
+
+/*!
+	setting the number of rows of a virtual list after the rows have changed,
+	the item with the name 'select' is selected (if it's shown)
+*/
+void ShowRows(HWND list, const ObjectsList & rows, const std::string & select)
+{
+	// the list keeps only the states of items (by their indexes)
+	// so they must be cleared
+	ListView_SetItemState(list, -1, 0, LVIS_FOCUSED|LVIS_SELECTED);
+	ListView_SetItemCountEx(list, rows.Size(), 0);
+
+	if( select.empty() )
+		return;
+
+	int id = rows.FindName(select);
+
+	if( id != -1 )
+	{
+		SelectOnlyOneItem(list, id);
+		ListView_EnsureVisible(list, id, false);
+	}
+}
+
+
+/*!
+	this function is called when the text in a filter edit has changed
+	(the selected item stays selected if it passes the filter)
+*/
+void FilterRows(HWND list, HWND edit, ObjectsList & rows)
 {
-LVITEM item;
+std::string filter, select;
+
+	int len = GetWindowTextLength(edit);
+	char * buffer = new char[len + 1];
+	GetWindowText(edit, buffer, len + 1);
+	filter = buffer;
+	delete [] buffer;
 
-	item.mask     = LVIF_TEXT;
-	item.pszText  = const_cast<char*>( name.c_str() );
-	item.iSubItem = 0;
+	int id = GetSelectedItem(list);
 
-	int id = ListView_InsertItem(list, &item);
-	ListView_SetItemText(list,id,1,const_cast<char*>( value.c_str() ));
+	if( id != -1 )
+		select = rows.Row(id)->first;
 
-return id;
+	if( rows.SetFilter(filter) )
+		ShowRows(list, rows, select);
 }
 
 
+/*!
+	searching for an item when the user types on the list (LVN_ODFINDITEM),
+	only names are searched
+*/
+int FindItem(const ObjectsList & rows, const NMLVFINDITEM * find)
+{
+	if( (find->lvfi.flags & (LVFI_STRING | LVFI_PARTIAL)) == 0 || !find->lvfi.psz )
+		return -1;
 
+return rows.FindPrefix(find->lvfi.psz, find->iStart, (find->lvfi.flags & LVFI_WRAP) != 0);
+}
 
 
-void ChangeItemInVariableList(HWND list, int id, const std::string & old_name,
-								 const std::string & new_name, const std::string & value)
+/*!
+	taking the current variables into the list
+*/
+void FillUpList(HWND list, const std::string & select)
 {
-	if( old_name != new_name )
-	{
-		ListView_DeleteItem(list, id);
-		// as we're using ListView_DeleteItem here the WM_NOTIFY is generated
-		// and system will call SetDisablingEditDeleteVariableButtons
-		// and eventually the focus will be changed into the 'add' button
-		// (it's a small inconvenience)
-
-		int new_id = AddNewItemToVariableList(list, new_name, value);
-		ListView_SetItemState(list, new_id, LVIS_FOCUSED|LVIS_SELECTED,LVIS_FOCUSED|LVIS_SELECTED);
-	}
-	else
-	{
-		ListView_SetItemText(list,id,1,const_cast<char*>( value.c_str() ));
-	}
+	rows.SetObjects( GetPrgRes()->GetVariablesSnapshot() );
+	ShowRows(list, rows, select);
+}
+
+
+/*!
+	giving the text of a row to the list (LVN_GETDISPINFO)
+*/
+void GetDispInfo(NMLVDISPINFO * info)
+{
+	if( (info->item.mask & LVIF_TEXT) == 0 || info->item.iItem < 0 || size_t(info->item.iItem) >= rows.Size() )
+		return;
+
+	ObjectsList::CIterator i = rows.Row(info->item.iItem);
+	const std::string & text = (info->item.iSubItem == 0) ? i->first : i->second.value;
+
+	lstrcpyn(info->item.pszText, text.c_str(), info->item.cchTextMax);
+}
+
+
+BOOL WmTabCommand_FilterChanged(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+	if( HIWORD(wParam) == EN_CHANGE )
+		FilterRows(GetDlgItem(hWnd, IDC_VARIABLES_LIST), GetDlgItem(hWnd, IDC_EDIT_VARIABLES_FILTER), rows);
+
+return true;
 }
 
 
@@ -215,14 +277,7 @@ void ChangeItemInVariableList(HWND list, int id, const std::string & old_name,
 */
 int GetSelectedItem(HWND list)
 {
-int id;
-int len = ListView_GetItemCount(list);
-
-	for(id = 0 ; id<len ; ++id)
-		if( ListView_GetItemState(list, id, LVIS_SELECTED) == LVIS_SELECTED )
-			return id;
-
-return -1;
+	return ListView_GetNextItem(list, -1, LVNI_SELECTED);
 }
 
 
@@ -232,11 +287,8 @@ return -1;
 */
 void SelectOnlyOneItem(HWND list, int id)
 {
-int len = ListView_GetItemCount(list);
-
-	for(int i = 0 ; i<len ; ++i)
-		ListView_SetItemState(list, i, 0, LVIS_FOCUSED|LVIS_SELECTED);
-
+	// -1 means all items
+	ListView_SetItemState(list, -1, 0, LVIS_FOCUSED|LVIS_SELECTED);
 	ListView_SetItemState(list, id, LVIS_FOCUSED|LVIS_SELECTED, LVIS_FOCUSED|LVIS_SELECTED);
 }
 
@@ -257,19 +309,22 @@ BOOL WmTabCommand_AddVariable(HWND, UINT message, WPARAM wParam, LPARAM lParam)
 		
 		HWND list = GetDlgItem(hWnd, IDC_VARIABLES_LIST);
 
+		// the list doesn't hold the table while it's being changed
+		rows.Reset();
 		GetPrgRes()->GetThreadController()->StopCalculating();
 		code = GetPrgRes()->GetVariables()->Add(name, value);
 		GetPrgRes()->VariablesChanged();
 		GetPrgRes()->GetThreadController()->StartCalculating();
 
 		if( code != ttmath::err_ok )
+		{
+			FillUpList(list, "");
 			ShowError(hWnd, code);
+		}
 		else
 		{
-			int id = AddNewItemToVariableList(list, name, value);
-			SelectOnlyOneItem(list,id);
-			GetPrgRes()->ReadVariablesFunctionsFromFile();
-			GetPrgRes()->SaveToFile();
+			GetPrgRes()->SaveVariableToFile(name);
+			FillUpList(list, name);
 		}
 	}
 	while( code != ttmath::err_ok );
@@ -297,25 +352,19 @@ adding = false;
 	if( id == -1 )
 		return true;
 
-	const int buffer_size = 300;
-	char * buffer = new char[buffer_size];
 	std::string old_name;
 	ttmath::ErrorCode code;
 	caption = GetPrgRes()->GetLanguages()->GuiMessage(Languages::dialog_box_edit_variable_caption);
 
-	ListView_GetItemText(list,id,0,buffer, buffer_size);
-	old_name = name = buffer;
-
-	ListView_GetItemText(list,id,1,buffer, buffer_size);
-	value = buffer;
-
-	delete [] buffer;
+	old_name = name = rows.Row(id)->first;
+	value    = rows.Row(id)->second.value;
 
 	do
 	{
 		if( !DialogBox(GetPrgRes()->GetInstance(), MAKEINTRESOURCE(IDD_DIALOG_ADD_VARIABLE), hWnd, DialogProcVariables) )
 			break;
 
+		rows.Reset();
 		GetPrgRes()->GetThreadController()->StopCalculating();
 
 		// firstly we're trying to change the name
@@ -329,12 +378,17 @@ adding = false;
 		GetPrgRes()->GetThreadController()->StartCalculating();
 
 		if( code != ttmath::err_ok )
+		{
+			FillUpList(list, old_name);
 			ShowError(list, code);
+		}
 		else
 		{
-			ChangeItemInVariableList(list, id, old_name, name, value);
-			GetPrgRes()->ReadVariablesFunctionsFromFile();
-			GetPrgRes()->SaveToFile();
+			if( old_name != name )
+				GetPrgRes()->SaveVariableToFile(old_name);
+
+			GetPrgRes()->SaveVariableToFile(name);
+			FillUpList(list, name);
 		}
 	}
 	while( code != ttmath::err_ok );
@@ -364,32 +418,27 @@ int items = ListView_GetSelectedCount(list);
 	}
 
 	int id;
-	const int buffer_size = 300;
-	char * buffer = new char[buffer_size];
+	std::vector<std::string> names;
 	bool all_deleted = true;
 
-	GetPrgRes()->ReadVariablesFunctionsFromFile();
-	GetPrgRes()->GetThreadController()->StopCalculating();
+	// the rows point into the current table so the names are copied first
+	for( id = GetSelectedItem(list) ; id != -1 ; id = ListView_GetNextItem(list, id, LVNI_SELECTED) )
+		names.push_back( rows.Row(id)->first );
 
-	for( id = ListView_GetItemCount(list)-1 ; id!=-1 ; --id )
-	{
-		if( ListView_GetItemState(list, id, LVIS_SELECTED) == LVIS_SELECTED )
-		{
-			ListView_GetItemText(list,id,0,buffer,buffer_size);
-			if( GetPrgRes()->GetVariables()->Delete(buffer) != ttmath::err_ok )
-				all_deleted = false;
-			else
-				ListView_DeleteItem(list, id);
+	rows.Reset();
+	GetPrgRes()->GetThreadController()->StopCalculating();
 
-			GetPrgRes()->VariablesChanged();
-		}
-	}
+	for(size_t i=0 ; i<names.size() ; ++i)
+		if( GetPrgRes()->GetVariables()->Delete(names[i]) != ttmath::err_ok )
+			all_deleted = false;
 
-	
+	GetPrgRes()->VariablesChanged();
 	GetPrgRes()->GetThreadController()->StartCalculating();
-	GetPrgRes()->SaveToFile();
 
-	delete [] buffer;
+	for(size_t i=0 ; i<names.size() ; ++i)
+		GetPrgRes()->SaveVariableToFile(names[i]);
+
+	FillUpList(list, "");
 
 	if( !all_deleted )
 		// there are some items which we've not deleted
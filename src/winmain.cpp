@@ -119,6 +119,7 @@ int APIENTRY WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR par, int)
 	GetPrgRes()->SaveToFile();
 
 	DestroyPadWindow();
+	TabWindowFunctions::TabulationTab::StopThread();
 	CloseHandle( (HANDLE)thread_handle );
 
 	}
@@ -0,0 +1,705 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "compileconfig.h"
+#include "worksheet.h"
+
+#include <algorithm>
+
+
+const char Worksheet::annotation[] = " -> ";
+
+
+
+Worksheet::Worksheet()
+{
+	last_id           = 0;
+	threads           = 1;
+	threads_used      = 0;
+	depth             = 0;
+	calculated        = 0;
+	stop_object       = 0;
+	separator         = "  ;  ";
+	languages         = 0;
+	variables_id      = -1;
+	functions_id      = -1;
+	last_variables_id = -1;
+	last_functions_id = -1;
+	was_run           = false;
+	remaining         = 0;
+}
+
+
+Worksheet::~Worksheet()
+{
+	Clear();
+}
+
+
+void Worksheet::SetThreads(unsigned int pthreads)
+{
+	threads = pthreads;
+}
+
+
+void Worksheet::SetStopObject(const volatile ttmath::StopCalculating * pstop_object)
+{
+	stop_object = pstop_object;
+}
+
+
+void Worksheet::SetObjectsId(int pvariables_id, int pfunctions_id)
+{
+	variables_id = pvariables_id;
+	functions_id = pfunctions_id;
+}
+
+
+void Worksheet::Clear()
+{
+	for(size_t i=0 ; i<lines.size() ; ++i)
+		delete lines[i];
+
+	lines.clear();
+}
+
+
+void Worksheet::SetSeparator(const char * new_separator)
+{
+	if( separator == new_separator )
+		return;
+
+	separator = new_separator;
+
+	for(size_t i=0 ; i<lines.size() ; ++i)
+		lines[i]->dirty = true;
+}
+
+
+bool Worksheet::IsWhiteCharacter(char c)
+{
+	return c==' ' || c=='\t';
+}
+
+
+/*!
+	the same characters as ttmath accepts in names
+*/
+bool Worksheet::IsNameCharacter(char c)
+{
+	return IsFirstNameCharacter(c) || (c>='0' && c<='9');
+}
+
+
+bool Worksheet::IsFirstNameCharacter(char c)
+{
+	return (c>='a' && c<='z') || (c>='A' && c<='Z') || c=='_';
+}
+
+
+/*!
+	a line of the same text is taken from the last lines (with its results),
+	if there are more such lines they are taken from the top
+*/
+void Worksheet::SetText(const std::string & text)
+{
+typedef std::multimap<std::string, Line*> OldLines;
+OldLines old_lines;
+OldLines::iterator old;
+size_t start = 0, end;
+Line line;
+
+	for(size_t i=0 ; i<lines.size() ; ++i)
+		old_lines.insert(std::make_pair(lines[i]->text, lines[i]));
+
+	lines.clear();
+
+	do
+	{
+		end = text.find('\n', start);
+
+		if( end == std::string::npos )
+			end = text.size();
+
+		line.text.assign(text, start, end - start);
+		SplitLine(line);
+		old = old_lines.find(line.text);
+
+		if( old != old_lines.end() )
+		{
+			lines.push_back(old->second);
+			old_lines.erase(old);
+		}
+		else
+		{
+			Line * new_line = new Line();
+			new_line->text       = line.text;
+			new_line->name       = line.name;
+			new_line->expression = line.expression;
+			new_line->id         = ++last_id;
+			new_line->code       = ttmath::err_ok;
+			new_line->calculated = false;
+			new_line->waiting    = 0;
+			new_line->dirty      = true;
+			new_line->selected   = false;
+			lines.push_back(new_line);
+		}
+
+		start = end + 1;
+	}
+	while( end < text.size() );
+
+	for(old = old_lines.begin() ; old != old_lines.end() ; ++old)
+		delete old->second;
+}
+
+
+/*!
+	removing '\r' and the annotation and checking whether the line is an assignment
+	(a name and one '=' character, "==" is the operator of comparison)
+*/
+void Worksheet::SplitLine(Line & line)
+{
+size_t i, name_start, name_end;
+
+	if( !line.text.empty() && line.text[line.text.size()-1] == '\r' )
+		line.text.erase(line.text.size()-1);
+
+	i = line.text.find(annotation + 1);	// without the first space
+
+	if( i != std::string::npos )
+	{
+		for( ; i>0 && IsWhiteCharacter(line.text[i-1]) ; --i);
+		line.text.erase(i);
+	}
+
+	line.name.clear();
+	line.expression = line.text;
+
+	for(i=0 ; i<line.text.size() && IsWhiteCharacter(line.text[i]) ; ++i);
+
+	if( i == line.text.size() )
+	{
+		// an empty line
+		line.expression.clear();
+		return;
+	}
+
+	if( !IsFirstNameCharacter(line.text[i]) )
+		return;
+
+	name_start = i;
+
+	for( ; i<line.text.size() && IsNameCharacter(line.text[i]) ; ++i);
+
+	name_end = i;
+
+	for( ; i<line.text.size() && IsWhiteCharacter(line.text[i]) ; ++i);
+
+	if( i == line.text.size() || line.text[i] != '=' )
+		return;
+
+	if( i+1 < line.text.size() && line.text[i+1] == '=' )
+		return;
+
+	line.name.assign(line.text, name_start, name_end - name_start);
+	line.expression.assign(line.text, i + 1, std::string::npos);
+}
+
+
+/*!
+	adding name-like parts of the string (whole runs of name characters)
+*/
+void Worksheet::AddNames(Line & line, const char * str)
+{
+	while( *str )
+	{
+		if( !IsNameCharacter(*str) )
+		{
+			++str;
+			continue;
+		}
+
+		const char * start = str;
+
+		while( IsNameCharacter(*str) )
+			++str;
+
+		line.names.push_back(std::string(start, str));
+	}
+}
+
+
+/*!
+	selecting variables and functions from the tables which can be used by the line
+	and remembering names which can be used
+*/
+void Worksheet::Select(Line & line)
+{
+ttmath::Objects::CIterator o;
+
+	line.names.clear();
+	symbols.Select(line.expression.c_str(), line.variables, line.functions);
+
+	AddNames(line, line.expression.c_str());
+
+	for(o = line.variables.Begin() ; o != line.variables.End() ; ++o)
+		AddNames(line, o->second.value.c_str());
+
+	for(o = line.functions.Begin() ; o != line.functions.End() ; ++o)
+		AddNames(line, o->second.value.c_str());
+
+	std::sort(line.names.begin(), line.names.end());
+	line.names.erase(std::unique(line.names.begin(), line.names.end()), line.names.end());
+	line.selected = true;
+}
+
+
+/*!
+	looking for the lines of the assignments which the line uses,
+	we don't parse the string but we take every name-like part of it
+	(as SymbolTable::Select() does) so there can be more lines than needed but never less
+
+	the parser reads a name to the end of a run of name characters but the name can
+	begin after a number (e.g. "2x"), so we take every part beginning with a letter
+*/
+void Worksheet::AddUses(Line & line, const std::map<std::string, size_t> & defined, size_t max_name_len)
+{
+std::map<std::string, size_t>::const_iterator d;
+
+	for(size_t i=0 ; i<line.names.size() ; ++i)
+	{
+		const std::string & name = line.names[i];
+		size_t start = 0;
+
+		if( name.size() > max_name_len )
+			start = name.size() - max_name_len;
+
+		for( ; start < name.size() ; ++start )
+			if( IsFirstNameCharacter(name[start]) )
+			{
+				d = defined.find(name.substr(start));
+
+				if( d != defined.end() )
+					line.uses.push_back(d->second);
+			}
+	}
+
+	std::sort(line.uses.begin(), line.uses.end());
+	line.uses.erase(std::unique(line.uses.begin(), line.uses.end()), line.uses.end());
+}
+
+
+/*!
+	the lines are taken from the top so an assignment is used only by the lines below it
+	(until the next assignment to the same variable),
+	a line is marked as dirty if it is new, if it was not calculated last time,
+	if its assignments are other lines now or if one of them is dirty
+*/
+void Worksheet::BuildGraph(bool all)
+{
+std::map<std::string, size_t> defined;
+std::vector<size_t> line_depth(lines.size(), 0);
+std::vector<unsigned long> use_ids;
+size_t max_name_len = 0;
+
+	depth      = 0;
+	calculated = 0;
+
+	for(size_t i=0 ; i<lines.size() ; ++i)
+	{
+		Line & line = *lines[i];
+
+		line.uses.clear();
+		line.used_by.clear();
+
+		// an assignment without an expression ("x =") is calculated to get its error
+		if( line.expression.empty() && line.name.empty() )
+		{
+			line.dirty = false;
+			continue;
+		}
+
+		if( all )
+			line.selected = false;
+
+		if( !line.selected )
+		{
+			Select(line);
+			line.dirty = true;
+		}
+
+		if( line.code == ttmath::err_interrupt )
+			line.dirty = true;
+
+		if( !defined.empty() )
+			AddUses(line, defined, max_name_len);
+
+		use_ids.clear();
+
+		for(size_t u=0 ; u<line.uses.size() ; ++u)
+		{
+			Line & assignment = *lines[line.uses[u]];
+
+			assignment.used_by.push_back(i);
+			use_ids.push_back(assignment.id);
+			line_depth[i] = std::max(line_depth[i], line_depth[line.uses[u]]);
+
+			if( assignment.dirty )
+				line.dirty = true;
+		}
+
+		if( use_ids != line.use_ids )
+		{
+			line.use_ids.swap(use_ids);
+			line.dirty = true;
+		}
+
+		line_depth[i] += 1;
+		depth = std::max(depth, line_depth[i]);
+
+		if( line.dirty )
+			++calculated;
+
+		if( !line.name.empty() )
+		{
+			// the names are checked before so "x = x + 1" uses the previous x
+			defined[line.name] = i;
+			max_name_len = std::max(max_name_len, line.name.size());
+		}
+	}
+}
+
+
+bool Worksheet::WasStopSignal() const
+{
+	return stop_object && stop_object->WasStopSignal();
+}
+
+
+void Worksheet::InitEvaluator(Evaluator & evaluator)
+{
+	evaluator.SetLanguages(languages);
+	evaluator.SetStopObject(stop_object);
+	evaluator.SetCacheSize(0);
+}
+
+
+/*!
+	the lines from 'uses' have been calculated,
+	the variables of the document are added to a copy of the line's table
+*/
+void Worksheet::Calculate(Evaluator & evaluator, size_t index)
+{
+Line & line = *lines[index];
+ttmath::Objects variables(line.variables);
+
+	line.dirty      = false;
+	line.calculated = false;
+	line.result.clear();
+	line.value.clear();
+
+	if( WasStopSignal() )
+	{
+		line.code = ttmath::err_interrupt;
+		return;
+	}
+
+	for(size_t u=0 ; u<line.uses.size() ; ++u)
+	{
+		const Line & assignment = *lines[line.uses[u]];
+
+		if( assignment.code != ttmath::err_ok )
+		{
+			// the variable has not been set
+			line.code   = ttmath::err_unknown_variable;
+			line.result = languages->ErrorMessage(settings.country, line.code);
+			return;
+		}
+
+		if( variables.IsDefined(assignment.name) )
+			variables.EditValue(assignment.name, assignment.value);
+		else
+			variables.Add(assignment.name, assignment.value);
+	}
+
+	evaluator.SetVariables(&variables);
+	evaluator.SetFunctions(&line.functions);
+
+	if( !line.name.empty() && line.expression.find_first_not_of(" \t") == std::string::npos )
+		// there is nothing to assign ("x =") - as "2+" it's an unexpected end,
+		// err_nothing_has_read has no message (an empty input shows nothing)
+		line.code = ttmath::err_unexpected_end;
+	else
+		line.code = evaluator.Parse(line.expression.c_str(), settings);
+
+	line.calculated = line.code == ttmath::err_ok && evaluator.Calculated();
+
+	if( line.code == ttmath::err_ok && !line.name.empty() )
+	{
+		if( !line.calculated || evaluator.ResultSize() != 1 )
+			line.code = ttmath::err_must_be_only_one_value;
+		else
+		if( evaluator.PrintValueForInput(0, line.value) )
+			line.code = ttmath::err_overflow;
+	}
+
+	if( line.code == ttmath::err_ok && line.calculated )
+	{
+		if( evaluator.PrintResult(line.result, separator.c_str()) )
+			line.code = ttmath::err_overflow;
+	}
+
+	if( line.code != ttmath::err_ok )
+	{
+		line.calculated = false;
+		line.result     = languages->ErrorMessage(settings.country, line.code);
+	}
+}
+
+
+ttmath::ErrorCode Worksheet::Run(const EvaluatorSettings & psettings,
+								 const ttmath::Objects & variables,
+								 const ttmath::Objects & functions,
+								 Languages * planguages)
+{
+unsigned int count = threads;
+
+	bool objects_changed = variables_id == -1 || functions_id == -1 ||
+						   variables_id != last_variables_id || functions_id != last_functions_id;
+
+	bool all = !was_run || objects_changed || !settings.Same(psettings) || languages != planguages;
+
+	if( !was_run || objects_changed )
+		symbols.Build(&variables, &functions);
+
+	settings          = psettings;
+	languages         = planguages;
+	last_variables_id = variables_id;
+	last_functions_id = functions_id;
+	was_run           = true;
+
+	BuildGraph(all);
+
+	if( count == 0 )
+		count = HowManyProcessors();
+
+	if( count > calculated )
+		count = (unsigned int)calculated;
+
+	if( count > 1 && depth < lines.size() )
+		RunThreads(count);
+	else
+		RunOneThread();
+
+	if( WasStopSignal() )
+		return ttmath::err_interrupt;
+
+return ttmath::err_ok;
+}
+
+
+/*!
+	the lines are calculated from the top (the assignments are always above the lines
+	which use them)
+*/
+void Worksheet::RunOneThread()
+{
+Evaluator evaluator;
+
+	InitEvaluator(evaluator);
+	threads_used = 1;
+
+	for(size_t i=0 ; i<lines.size() ; ++i)
+		if( lines[i]->dirty )
+			Calculate(evaluator, i);
+}
+
+
+void Worksheet::RunThreads(unsigned int count)
+{
+std::vector<Worker*> workers;
+
+	ready.clear();
+	remaining = calculated;
+
+	// only dirty lines are calculated, a line which uses a dirty line is dirty too
+	for(size_t i=0 ; i<lines.size() ; ++i)
+	{
+		Line & line = *lines[i];
+
+		if( !line.dirty )
+			continue;
+
+		line.waiting = 0;
+
+		for(size_t u=0 ; u<line.uses.size() ; ++u)
+			if( lines[line.uses[u]]->dirty )
+				++line.waiting;
+
+		if( line.waiting == 0 )
+			ready.push_back(i);
+	}
+
+	for(unsigned int w=0 ; w<count ; ++w)
+	{
+		Worker * worker = new Worker();
+		worker->sheet = this;
+		InitEvaluator(worker->evaluator);
+
+		if( !StartThread(worker->thread, WorkerThread, worker) )
+		{
+			// the lines are calculated by the started workers
+			delete worker;
+			break;
+		}
+
+		workers.push_back(worker);
+	}
+
+	threads_used = (unsigned int)workers.size();
+
+	if( workers.empty() )
+	{
+		RunOneThread();
+		return;
+	}
+
+	for(size_t w=0 ; w<workers.size() ; ++w)
+	{
+		JoinThread(workers[w]->thread);
+		delete workers[w];
+	}
+}
+
+
+void * Worksheet::WorkerThread(void * arg)
+{
+	Worker * worker = reinterpret_cast<Worker*>(arg);
+	worker->sheet->WorkerLoop(*worker);
+
+return 0;
+}
+
+
+/*!
+	a worker takes a ready line, calculates it without the lock and then the lines
+	which were waiting only for this one are ready
+*/
+void Worksheet::WorkerLoop(Worker & worker)
+{
+	mutex.Lock();
+
+	while( true )
+	{
+		while( ready.empty() && remaining > 0 )
+			ready_cond.Wait(mutex);
+
+		if( remaining == 0 )
+			break;
+
+		size_t index = ready.front();
+		ready.pop_front();
+		mutex.Unlock();
+
+		Calculate(worker.evaluator, index);
+
+		mutex.Lock();
+		--remaining;
+
+		const std::vector<size_t> & used_by = lines[index]->used_by;
+
+		for(size_t i=0 ; i<used_by.size() ; ++i)
+			if( --lines[used_by[i]]->waiting == 0 )
+				ready.push_back(used_by[i]);
+
+		if( remaining == 0 || !ready.empty() )
+			ready_cond.Broadcast();
+	}
+
+	mutex.Unlock();
+}
+
+
+void Worksheet::Annotate(std::string & text, const char * new_line) const
+{
+	text.clear();
+
+	for(size_t i=0 ; i<lines.size() ; ++i)
+	{
+		text += lines[i]->text;
+
+		if( !lines[i]->result.empty() )
+		{
+			text += annotation;
+			text += lines[i]->result;
+		}
+
+		if( i+1 < lines.size() )
+			text += new_line;
+	}
+}
+
+
+size_t Worksheet::Size() const
+{
+	return lines.size();
+}
+
+
+const Worksheet::Line & Worksheet::GetLine(size_t index) const
+{
+	return *lines[index];
+}
+
+
+size_t Worksheet::Depth() const
+{
+	return depth;
+}
+
+
+unsigned int Worksheet::ThreadsUsed() const
+{
+	return threads_used;
+}
+
+
+size_t Worksheet::Calculated() const
+{
+	return calculated;
+}
@@ -0,0 +1,283 @@
+/*
+ * This file is a part of TTCalc - a mathematical calculator
+ * and is distributed under the (new) BSD licence.
+ * Author: Tomasz Sowa <t.sowa@ttmath.org>
+ */
+
+/* 
+ * Copyright (c) 2006-2011, Tomasz Sowa
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *    
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *    
+ *  * Neither the name Tomasz Sowa nor the names of contributors to this
+ *    project may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef headerfileworksheet
+#define headerfileworksheet
+
+/*!
+	\file worksheet.h
+    \brief calculating all lines of a document (the pad) by many threads
+*/
+
+#include "compileconfig.h"
+#include "evaluator.h"
+#include "symboltable.h"
+#include "threads.h"
+
+#include <ttmath/ttmathobjects.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+
+
+/*!
+	\brief calculating all lines of a document
+
+	each line is an expression or an assignment to a variable of the document:
+		name = expression
+	the variable can be used by the next lines (the lines above see the variable
+	from the table of variables or the previous assignment to it), the value is
+	given as a number so the expression of the assignment is calculated only once
+
+	the result of a line is appended to it as an annotation (" -> result"),
+	SetText() removes annotations so the annotated text can be calculated again
+
+	lines are calculated as if they were calculated one after another but lines
+	which don't use each other's variables are calculated at the same time: each line
+	knows the lines of the assignments it uses (a name-like part of the line, or of
+	a value of a variable or a body of a function used by the line, is the name
+	of a variable assigned above), a line is given to a free thread when all these
+	lines have been calculated
+
+	the lines are kept between calls to Run() and only lines which have changed
+	are calculated again (with the lines which use them, directly or not): SetText()
+	takes the results of the last lines of the same text (they can be moved),
+	Run() calculates a line when it is new, when its assignments are different
+	(e.g. an assignment has been added above) or when one of them is calculated,
+	all lines are calculated when the settings or the tables of variables and
+	functions have changed (SetObjectsId())
+
+	usage:
+		Worksheet sheet;
+		sheet.SetThreads(0);
+		sheet.SetText(text);
+		sheet.Run(settings, variables, functions, &languages);
+		sheet.Annotate(text, "\n");
+*/
+class Worksheet
+{
+public:
+
+	struct Line
+	{
+		// the number of the line which doesn't change when the line is moved
+		unsigned long id;
+
+		// the text of the line without the annotation
+		std::string text;
+
+		// the name of the variable if the line is an assignment
+		std::string name;
+
+		// the text or the part of it after '=' if the line is an assignment
+		std::string expression;
+
+		ttmath::ErrorCode code;
+		bool calculated;
+
+		// the printed result or an error message (empty if nothing was calculated)
+		std::string result;
+
+		// the value of the variable for the next lines (only for assignments)
+		std::string value;
+
+		// lines of the assignments used by this line and lines which use this assignment
+		std::vector<size_t> uses;
+		std::vector<size_t> used_by;
+
+		// ids of the lines from 'uses' when the line was calculated
+		std::vector<unsigned long> use_ids;
+
+		// how many lines from 'uses' have not been calculated yet
+		size_t waiting;
+
+		// the line has to be calculated
+		bool dirty;
+
+		// variables and functions from the tables which can be used by the line
+		// and name-like parts of the expression and of them (they are set once
+		// for the text and they are used when looking for assignments)
+		bool selected;
+		ttmath::Objects variables;
+		ttmath::Objects functions;
+		std::vector<std::string> names;
+	};
+
+
+	/*!
+		the beginning of an annotation
+	*/
+	static const char annotation[];
+
+
+	Worksheet();
+	~Worksheet();
+
+
+	/*!
+		how many threads are used by Run(), zero means as many as processors (default: 1)
+	*/
+	void SetThreads(unsigned int threads);
+
+
+	/*!
+		the object is checked before each line (and passed to the parsers),
+		lines which were not calculated have err_interrupt
+	*/
+	void SetStopObject(const volatile ttmath::StopCalculating * stop_object);
+
+
+	/*!
+		identifiers of the current state of the tables of variables and functions,
+		if they have changed all lines are calculated again (by default they are -1
+		and all lines are always calculated)
+	*/
+	void SetObjectsId(int variables_id, int functions_id);
+
+
+	/*!
+		dividing the text into lines ("\n" or "\r\n"),
+		annotations are removed and assignments are found
+	*/
+	void SetText(const std::string & text);
+
+
+	/*!
+		forgetting all lines (the symbol table of the variables and functions
+		is kept, it's built again only when their ids have changed)
+	*/
+	void Clear();
+
+
+	/*!
+		the separator of values of a line which gives more values (default: "  ;  "),
+		if it's changed all lines are calculated again
+	*/
+	void SetSeparator(const char * separator);
+
+
+	/*!
+		calculating all lines, the variables and functions are used only during
+		the call, returning err_interrupt if the calculations were stopped
+	*/
+	ttmath::ErrorCode Run(const EvaluatorSettings & settings,
+						  const ttmath::Objects & variables,
+						  const ttmath::Objects & functions,
+						  Languages * languages);
+
+
+	/*!
+		the text with results appended to the lines, lines are separated by 'new_line'
+	*/
+	void Annotate(std::string & text, const char * new_line) const;
+
+
+	size_t Size() const;
+	const Line & GetLine(size_t index) const;
+
+
+	/*!
+		statistics of the last Run(): the number of lines in the longest chain
+		of lines which use each other, the number of threads used and
+		the number of lines which were calculated
+	*/
+	size_t Depth() const;
+	unsigned int ThreadsUsed() const;
+	size_t Calculated() const;
+
+
+private:
+
+	struct Worker
+	{
+		Worksheet * sheet;
+		pthread_t thread;
+		Evaluator evaluator;
+	};
+
+	std::vector<Line*> lines;
+	unsigned long last_id;
+
+	unsigned int threads;
+	unsigned int threads_used;
+	size_t depth;
+	size_t calculated;
+	const volatile ttmath::StopCalculating * stop_object;
+	std::string separator;
+
+	// the settings and the tables of the last Run()
+	EvaluatorSettings settings;
+	Languages * languages;
+	int variables_id, functions_id;
+	int last_variables_id, last_functions_id;
+	bool was_run;
+
+	// names from the tables of variables and functions
+	SymbolTable symbols;
+
+	// lines which can be calculated now
+	std::deque<size_t> ready;
+	size_t remaining;
+
+	Mutex mutex;
+	Condition ready_cond;	// signaled when a line is ready or all lines are finished
+
+	static bool IsWhiteCharacter(char c);
+	static bool IsNameCharacter(char c);
+	static bool IsFirstNameCharacter(char c);
+	static void SplitLine(Line & line);
+	static void AddNames(Line & line, const char * str);
+
+	void Select(Line & line);
+	void BuildGraph(bool all);
+	void AddUses(Line & line, const std::map<std::string, size_t> & defined, size_t max_name_len);
+	bool WasStopSignal() const;
+	void InitEvaluator(Evaluator & evaluator);
+	void Calculate(Evaluator & evaluator, size_t index);
+	void RunOneThread();
+	void RunThreads(unsigned int count);
+
+	static void * WorkerThread(void * arg);
+	void WorkerLoop(Worker & worker);
+
+	Worksheet(const Worksheet &);
+	Worksheet & operator=(const Worksheet &);
+};
+
+
+#endif